@@ -5,8 +5,21 @@
 #ifndef AVL_H_
 #define AVL_H_
 
+#include <algorithm>
+#include <climits>
+#include <utility>
+#include <math.h>
+
 #include "List.h"
 #include "Node.h"
+#include "AVLIter.h"
+#include "AVLCounters.h"
+#include "AVLStats.h"
+#include "ForkJoin.h"
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 
 /*******************************************************************************
@@ -24,57 +37,1185 @@ class AVL
 public:
 	Node<type> *root;
 
+	AVL();
+	~AVL();
+
 	bool insert(int id, type item);
+	int  insertBatch(pair<int, type> *batch, int count);
+
+	// UPSERT - one descent, returning the node that holds id and whether it
+	//          was inserted
+	pair<Node<type>*, bool> findOrInsert(int id);
+	template<class... Args>
+	pair<Node<type>*, bool> try_emplace(int id, Args&&... args);
+	bool insert_or_assign(int id, const type& item);
+	bool remove(int id);
+	type* find(int id);
+	Node<type>* findNode(int id);
+	void clear();
+
+	// BULK LOAD - replaces the contents, in parallel on pool
+	long build(pair<int, type> *items, long count, ForkJoin &pool = ForkJoin::shared());
+
+	// SET OPERATIONS - this tree becomes the result, other is left unchanged
+	void unionWith(const AVL<type>& other, ForkJoin &pool = ForkJoin::shared());
+	void intersect(const AVL<type>& other, ForkJoin &pool = ForkJoin::shared());
+	void difference(const AVL<type>& other, ForkJoin &pool = ForkJoin::shared());
+
+	// SPLIT / CONCATENATE - move whole key ranges between trees in O(log n)
+	void splitOff(int id, AVL<type>& upper);
+	void concat(AVL<type>& other);
+
+	// PARALLEL TRAVERSAL - subtrees near the root become tasks on pool
+	template<class Visit>
+	void parallelForEach(Visit visit, ForkJoin &pool = ForkJoin::shared());
+	template<class Result, class Map, class Combine>
+	Result parallelReduce(Result init, Map map, Combine combine,
+	                      ForkJoin &pool = ForkJoin::shared());
+
+	// ITERATION - in key order
+	AVLIter<type> begin();
+	AVLIter<type> end();
+	AVLIter<type> lowerBound(int id);
+	AVLIter<type> upperBound(int id);
+
+	// RANGES - keys in [lo, hi], O(log n + k) for k keys in range
+	pair<AVLIter<type>, AVLIter<type> > range(int lo, int hi);
+	template<class Visit>
+	void forRange(int lo, int hi, Visit visit);
+	long countRange(int lo, int hi);
+	long removeRange(int lo, int hi);
+
+	// SHAPE - one pass over the tree
+	AVLStats stats();
+	static long nodeBytes();
+
+	// VALIDATION
+	bool validate();
+	bool validatePath(int id);
 
 private:
+	// nodes are owned by the tree, so copies are not allowed
+	AVL(const AVL<type>&);
+	AVL<type>& operator = (const AVL<type>&);
+
+	// an AVL tree this tall would need more than 10^20 nodes
+	static const int MAX_HEIGHT = 96;
+
 	Node<type> *first;
 	Node<type> *second;
 	Node<type> *third;
 
 	// INSERT helpers
-	Node<type>* findLeafNode(int);
+	static bool keyLess(const pair<int, type>&, const pair<int, type>&);
+	Node<type>* findLeafNode(int, Node<type>** match = NULL);
 	void attachNode(Node<type>*, Node<type>*);
 	void insertionUpdate(Node<type>*);
 
-	// BALANCE helpers
-	void balance(Node<type>*);
-	void removalBalance(Node<type>*);
-	Node<type>* balance00(Node<type> *node);
-	Node<type>* balance01(Node<type> *node);
-	Node<type>* balance10(Node<type> *node);
-	Node<type>* balance11(Node<type> *node);
-	void connectSubtree(Node<type>*);
-};
+	// BULK LOAD helpers
+	static const long PARALLEL_GRAIN = 1 << 14;
+	static long countDuplicates(pair<int, type>*, long, ForkJoin&);
+	static Node<type>* buildBalanced(pair<int, type>*, long, Node<type>*, ForkJoin&);
+
+	// JOIN helpers - subtrees travel with their heights, the middle node of a
+	//                join is linked between two subtrees whatever it held
+	static void childHeights(Node<type>*, int, int&, int&);
+	static int  link(Node<type>*, Node<type>*, int, Node<type>*, int);
+	static Node<type>* rotateLeft(Node<type>*, Node<type>*, int, Node<type>*, int, int&);
+	static Node<type>* rotateRight(Node<type>*, Node<type>*, int, Node<type>*, int, int&);
+	static Node<type>* join(Node<type>*, int, Node<type>*, Node<type>*, int, int&);
+	static Node<type>* joinRight(Node<type>*, int, Node<type>*, Node<type>*, int, int&);
+	static Node<type>* joinLeft(Node<type>*, int, Node<type>*, Node<type>*, int, int&);
+	static Node<type>* join2(Node<type>*, int, Node<type>*, int, int&);
+	static Node<type>* splitLast(Node<type>*, int, Node<type>*&, int&);
+	static void split(Node<type>*, int, int, Node<type>*&, int&, Node<type>*&,
+	                  Node<type>*&, int&);
+	static void freeSubtree(Node<type>*);
+
+	// SET OPERATION helpers
+	static const int PARALLEL_LEVELS = 12;
+	static Node<type>* copySubtree(Node<type>*, int, ForkJoin&);
+	static Node<type>* unite(Node<type>*, int, Node<type>*, int, int&, ForkJoin&);
+	static Node<type>* common(Node<type>*, int, Node<type>*, int, int&, ForkJoin&);
+	static Node<type>* subtract(Node<type>*, int, Node<type>*, int, int&, ForkJoin&);
+
+	// TRAVERSAL helpers
+	template<class Visit>
+	static void visitSubtree(Node<type>*, Visit&);
+	template<class Visit>
+	static void forEachSubtree(Node<type>*, int, Visit&, ForkJoin&);
+	template<class Result, class Map, class Combine>
+	static Result reduceSubtree(Node<type>*, int, const Result&, Map&, Combine&, ForkJoin&);
+
+	// BALANCE helpers
+	void balance(Node<type>*);
+	void removalBalance(Node<type>*);
+	void rotateUp(Node<type>*);
+	Node<type>* balance00(Node<type> *node);
+	Node<type>* balance01(Node<type> *node);
+	Node<type>* balance10(Node<type> *node);
+	Node<type>* balance11(Node<type> *node);
+	void connectSubtree(Node<type>*);
+
+	// STATS helpers
+	static const int CACHE_LINE = 64;
+	static int linesOf(Node<type>*);
+
+	// VALIDATION helpers
+	static bool stateMatches(char state, int lHeight, int rHeight);
+	static int  stateHeight(Node<type>*);
+	static bool nodeValid(Node<type>*);
+};
+
+
+/*******************************************************************************
+ * CONSTRUCTOR / DESTRUCTOR
+ ******************************************************************************/
+template<class type>
+AVL<type> :: AVL()
+{
+	root   = NULL;
+	first  = NULL;
+	second = NULL;
+	third  = NULL;
+}
+
+template<class type>
+AVL<type> :: ~AVL()
+{
+	clear();
+}
+
+
+/*******************************************************************************
+ * FUNCTION - clear
+ * -----------------------------------------------------------------------------
+ * This function deletes every node in the tree. Nodes are freed bottom up by
+ * climbing the parent pointers, so no stack is needed however deep the tree.
+ ******************************************************************************/
+template<class type>
+void AVL<type> :: clear()
+{
+	freeSubtree(root);
+	root = NULL;
+}
+
+template<class type>
+void AVL<type> :: freeSubtree(Node<type> *top)
+{
+	Node<type> *node = top;
+
+	while (node)
+	{
+		if (node->left)
+			node = node->left;
+		else if (node->right)
+			node = node->right;
+		else
+		{
+			Node<type> *p_node = node == top ? NULL : node->parent;
+			if (p_node)
+				(p_node->left == node ? p_node->left : p_node->right) = NULL;
+			delete node;
+			node = p_node;
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - insert
+ * -----------------------------------------------------------------------------
+ * This function attempts to insert a node into the AVL tree.
+ * -----------------------------------------------------------------------------
+ * return: bool - if the insertion was a success
+ ******************************************************************************/
+template<class type>
+bool AVL<type> :: insert(int id, type item)
+{
+	if (!root)
+	{
+		AVL_COUNT(ALLOCATIONS);
+		root = new Node<type>(id, item);
+		return true;
+	}
+	else
+	{
+		Node<type> *p_node = findLeafNode(id);
+		if (p_node)
+		{
+			AVL_COUNT(ALLOCATIONS);
+			attachNode(p_node, new Node<type>(id, item));
+			insertionUpdate(p_node);
+			return true;
+		}
+		return false;
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - try_emplace / findOrInsert / insert_or_assign
+ * -----------------------------------------------------------------------------
+ * These functions share one descent between the lookup and the insertion.
+ * findLeafNode stops at the node holding id if there is one; otherwise it
+ * has already marked the path for insertionUpdate and returns the leaf to
+ * attach to. Rebalancing relinks nodes without moving items, so the node
+ * returned still holds id afterwards.
+ *
+ * try_emplace builds the item from args only when id is new, and
+ * findOrInsert leaves a new item default constructed for the caller to fill
+ * in through the node. insert_or_assign overwrites the item of an existing
+ * node in place.
+ * -----------------------------------------------------------------------------
+ * return: the node holding id, and true if it was inserted. insert_or_assign
+ *         returns only the flag.
+ ******************************************************************************/
+template<class type>
+template<class... Args>
+pair<Node<type>*, bool> AVL<type> :: try_emplace(int id, Args&&... args)
+{
+	Node<type> *match;
+	Node<type> *p_node = findLeafNode(id, &match);
+
+	if (match)
+		return make_pair(match, false);
+
+	AVL_COUNT(ALLOCATIONS);
+	Node<type> *node = new Node<type>(id, type(forward<Args>(args)...));
+	attachNode(p_node, node);
+	if (p_node)
+		insertionUpdate(p_node);
+	return make_pair(node, true);
+}
+
+template<class type>
+pair<Node<type>*, bool> AVL<type> :: findOrInsert(int id)
+{
+	return try_emplace(id);
+}
+
+template<class type>
+bool AVL<type> :: insert_or_assign(int id, const type& item)
+{
+	pair<Node<type>*, bool> at = try_emplace(id, item);
+
+	if (!at.second)
+		at.first->item = item;
+	return at.second;
+}
+
+/*******************************************************************************
+ * FUNCTION - insertBatch
+ * -----------------------------------------------------------------------------
+ * This function inserts count (key, item) pairs, such as a batch drained from
+ * an ingest queue. The batch is sorted by key in place first, so consecutive
+ * descents share most of their path and find it already in cache. The sort
+ * is stable, so of two pairs with one key the earlier one wins as it would
+ * with insert.
+ * -----------------------------------------------------------------------------
+ * return: int - how many pairs were inserted
+ ******************************************************************************/
+template<class type>
+int AVL<type> :: insertBatch(pair<int, type> *batch, int count)
+{
+	int inserted = 0;
+
+	stable_sort(batch, batch + count, keyLess);
+
+	for (int i = 0; i < count; ++i)
+		if (insert(batch[i].first, batch[i].second))
+			++inserted;
+	return inserted;
+}
+
+
+template<class type>
+bool AVL<type> :: keyLess(const pair<int, type>& a, const pair<int, type>& b)
+{
+	return a.first < b.first;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - build
+ * -----------------------------------------------------------------------------
+ * This function replaces the tree with the given (key, item) pairs, which may
+ * come in any order. The pairs are merge sorted by key in place on pool, with
+ * a temporary buffer of count pairs. They are then checked for repeated keys
+ * in parallel; when a key repeats, only its first pair is kept, as insert
+ * would do. Finally the tree is built top down from the sorted run, with the
+ * two halves of every large run built on different threads.
+ * -----------------------------------------------------------------------------
+ * return: long - how many pairs went into the tree
+ ******************************************************************************/
+template<class type>
+long AVL<type> :: build(pair<int, type> *items, long count, ForkJoin &pool)
+{
+	clear();
+
+	parallelSort(items, count, keyLess, pool);
+
+	if (countDuplicates(items, count, pool) > 0)
+	{
+		count = unique(items, items + count,
+		               [](const pair<int, type>& a, const pair<int, type>& b)
+		               { return a.first == b.first; }) - items;
+	}
+
+	AVL_COUNT_N(ALLOCATIONS, count);
+	root = buildBalanced(items, count, NULL, pool);
+	return count;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - countDuplicates
+ * -----------------------------------------------------------------------------
+ * return: pairs of a sorted run whose key equals the key before them
+ ******************************************************************************/
+template<class type>
+long AVL<type> :: countDuplicates(pair<int, type> *items, long count, ForkJoin &pool)
+{
+	if (count <= PARALLEL_GRAIN)
+	{
+		long repeats = 0;
+		for (long i = 1; i < count; ++i)
+			if (items[i].first == items[i - 1].first)
+				++repeats;
+		return repeats;
+	}
+
+	long half = count / 2;
+	long left, right;
+	pool.invoke([&]() { left  = countDuplicates(items, half, pool); },
+	            [&]() { right = countDuplicates(items + half - 1, count - half + 1, pool); });
+	return left + right;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - buildBalanced
+ * -----------------------------------------------------------------------------
+ * The middle pair of the run becomes the node and the halves its subtrees.
+ * The left half gets the extra pair when the run is even, so a subtree of n
+ * nodes is floor(log2 n) + 1 high and the node is left heavy exactly when its
+ * left half needs one more level than its right.
+ * -----------------------------------------------------------------------------
+ * return: root of the subtree built from the run
+ ******************************************************************************/
+template<class type>
+Node<type>* AVL<type> :: buildBalanced(pair<int, type> *items, long count,
+                                       Node<type> *parent, ForkJoin &pool)
+{
+	if (count == 0)
+		return NULL;
+
+	long mid    = count / 2;
+	long rCount = count - 1 - mid;
+	Node<type> *node = new Node<type>(items[mid].first, items[mid].second);
+
+	int lLevels = mid    ? 64 - __builtin_clzll(mid)    : 0;
+	int rLevels = rCount ? 64 - __builtin_clzll(rCount) : 0;
+
+	node->parent = parent;
+	node->state  = lLevels > rLevels ? '<' : '=';
+
+	if (count > PARALLEL_GRAIN)
+		pool.invoke([&]() { node->left  = buildBalanced(items, mid, node, pool); },
+		            [&]() { node->right = buildBalanced(items + mid + 1, rCount, node, pool); });
+	else
+	{
+		node->left  = buildBalanced(items, mid, node, pool);
+		node->right = buildBalanced(items + mid + 1, rCount, node, pool);
+	}
+	return node;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - unionWith / intersect / difference
+ * -----------------------------------------------------------------------------
+ * These functions are the join based set algorithms of Blelloch, Ferizovic and
+ * Sun, "Just Join for Parallel Ordered Sets". This tree is split by the root
+ * key of other, the two sides are combined with the two subtrees of other in
+ * parallel, and the results are joined back together. For trees of m and n
+ * nodes, m <= n, that is O(m log(n/m + 1)) work and O(log n log m) depth.
+ *
+ * Nodes of this tree are relinked rather than copied. Where both trees hold a
+ * key this tree's item is kept, and union copies only the nodes of other
+ * whose keys this tree lacks.
+ ******************************************************************************/
+template<class type>
+void AVL<type> :: unionWith(const AVL<type>& other, ForkJoin &pool)
+{
+	int height;
+
+	if (&other == this)
+		return;
+	root = unite(root, stateHeight(root), other.root, stateHeight(other.root), height, pool);
+	if (root)
+		root->parent = NULL;
+}
+
+template<class type>
+void AVL<type> :: intersect(const AVL<type>& other, ForkJoin &pool)
+{
+	int height;
+
+	if (&other == this)
+		return;
+	root = common(root, stateHeight(root), other.root, stateHeight(other.root), height, pool);
+	if (root)
+		root->parent = NULL;
+}
+
+template<class type>
+void AVL<type> :: difference(const AVL<type>& other, ForkJoin &pool)
+{
+	int height;
+
+	if (&other == this)
+	{
+		clear();
+		return;
+	}
+	root = subtract(root, stateHeight(root), other.root, stateHeight(other.root), height, pool);
+	if (root)
+		root->parent = NULL;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - splitOff
+ * -----------------------------------------------------------------------------
+ * This function moves every node whose key is id or above into upper, which
+ * loses whatever it held. Both trees are left balanced after O(log n) work.
+ ******************************************************************************/
+template<class type>
+void AVL<type> :: splitOff(int id, AVL<type>& upper)
+{
+	Node<type> *left, *match, *right;
+	int lHeight, rHeight;
+
+	if (&upper == this)
+		return;
+	upper.clear();
+	split(root, stateHeight(root), id, left, lHeight, match, right, rHeight);
+	if (match)
+		right = join(NULL, 0, match, right, rHeight, rHeight);
+
+	root       = left;
+	upper.root = right;
+	if (root)
+		root->parent = NULL;
+	if (upper.root)
+		upper.root->parent = NULL;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - concat
+ * -----------------------------------------------------------------------------
+ * This function moves every node of other into this tree, leaving other
+ * empty. The keys of other must all lie below, or all above, the keys of
+ * this tree, so the two trees are joined rather than merged in O(log n).
+ ******************************************************************************/
+template<class type>
+void AVL<type> :: concat(AVL<type>& other)
+{
+	Node<type> *low  = root;
+	Node<type> *high = other.root;
+	int height;
+
+	if (&other == this || !other.root)
+		return;
+	if (root && other.root->id < root->id)
+		swap(low, high);
+
+	root = join2(low, stateHeight(low), high, stateHeight(high), height);
+	root->parent = NULL;
+	other.root   = NULL;
+}
+
+/*******************************************************************************
+ * FUNCTION - unite / common / subtract
+ * -----------------------------------------------------------------------------
+ * The recursive halves of the set operations. t1 is a subtree being rebuilt,
+ * t2 a subtree of the other tree, which is only read; both come with their
+ * heights. Halves are run in parallel while both subtrees are more than
+ * PARALLEL_LEVELS high.
+ * -----------------------------------------------------------------------------
+ * return: root of the result, its height in height
+ ******************************************************************************/
+template<class type>
+Node<type>* AVL<type> :: unite(Node<type> *t1, int h1, Node<type> *t2, int h2,
+                               int &height, ForkJoin &pool)
+{
+	if (!t2)
+	{
+		height = h1;
+		return t1;
+	}
+	if (!t1)
+	{
+		height = h2;
+		return copySubtree(t2, h2, pool);
+	}
+
+	Node<type> *l1, *match, *r1, *l, *r;
+	int hl1, hr1, hl2, hr2, hl, hr;
+
+	childHeights(t2, h2, hl2, hr2);
+	split(t1, h1, t2->id, l1, hl1, match, r1, hr1);
+
+	auto left  = [&]() { l = unite(l1, hl1, t2->left,  hl2, hl, pool); };
+	auto right = [&]() { r = unite(r1, hr1, t2->right, hr2, hr, pool); };
+	if (h1 > PARALLEL_LEVELS && h2 > PARALLEL_LEVELS)
+		pool.invoke(left, right);
+	else
+	{
+		left();
+		right();
+	}
+
+	if (!match)
+	{
+		AVL_COUNT(ALLOCATIONS);
+		match = new Node<type>(t2->id, t2->item);
+	}
+	return join(l, hl, match, r, hr, height);
+}
+
+template<class type>
+Node<type>* AVL<type> :: common(Node<type> *t1, int h1, Node<type> *t2, int h2,
+                                int &height, ForkJoin &pool)
+{
+	if (!t1 || !t2)
+	{
+		freeSubtree(t1);
+		height = 0;
+		return NULL;
+	}
+
+	Node<type> *l1, *match, *r1, *l, *r;
+	int hl1, hr1, hl2, hr2, hl, hr;
+
+	childHeights(t2, h2, hl2, hr2);
+	split(t1, h1, t2->id, l1, hl1, match, r1, hr1);
+
+	auto left  = [&]() { l = common(l1, hl1, t2->left,  hl2, hl, pool); };
+	auto right = [&]() { r = common(r1, hr1, t2->right, hr2, hr, pool); };
+	if (h1 > PARALLEL_LEVELS && h2 > PARALLEL_LEVELS)
+		pool.invoke(left, right);
+	else
+	{
+		left();
+		right();
+	}
+
+	if (match)
+		return join(l, hl, match, r, hr, height);
+	return join2(l, hl, r, hr, height);
+}
+
+template<class type>
+Node<type>* AVL<type> :: subtract(Node<type> *t1, int h1, Node<type> *t2, int h2,
+                                  int &height, ForkJoin &pool)
+{
+	if (!t1 || !t2)
+	{
+		height = h1;
+		return t1;
+	}
+
+	Node<type> *l1, *match, *r1, *l, *r;
+	int hl1, hr1, hl2, hr2, hl, hr;
+
+	childHeights(t2, h2, hl2, hr2);
+	split(t1, h1, t2->id, l1, hl1, match, r1, hr1);
+
+	auto left  = [&]() { l = subtract(l1, hl1, t2->left,  hl2, hl, pool); };
+	auto right = [&]() { r = subtract(r1, hr1, t2->right, hr2, hr, pool); };
+	if (h1 > PARALLEL_LEVELS && h2 > PARALLEL_LEVELS)
+		pool.invoke(left, right);
+	else
+	{
+		left();
+		right();
+	}
+
+	delete match;
+	return join2(l, hl, r, hr, height);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - copySubtree
+ * -----------------------------------------------------------------------------
+ * return: a copy of the subtree of the given height, with the same shape and
+ *         states, built in parallel while it is high enough
+ ******************************************************************************/
+template<class type>
+Node<type>* AVL<type> :: copySubtree(Node<type> *source, int height, ForkJoin &pool)
+{
+	if (!source)
+		return NULL;
+
+	int hl, hr;
+	Node<type> *node = new Node<type>(source->id, source->item);
+
+	AVL_COUNT(ALLOCATIONS);
+	node->state = source->state;
+	childHeights(source, height, hl, hr);
+
+	auto left  = [&]() { node->left  = copySubtree(source->left,  hl, pool); };
+	auto right = [&]() { node->right = copySubtree(source->right, hr, pool); };
+	if (height > PARALLEL_LEVELS)
+		pool.invoke(left, right);
+	else
+	{
+		left();
+		right();
+	}
+
+	if (node->left)
+		node->left->parent = node;
+	if (node->right)
+		node->right->parent = node;
+	return node;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - childHeights / link
+ * -----------------------------------------------------------------------------
+ * childHeights reads the heights of a node's subtrees off its state. link
+ * hangs two subtrees under node and sets its state from their heights, which
+ * must differ by at most one.
+ * -----------------------------------------------------------------------------
+ * return: height of the linked subtree
+ ******************************************************************************/
+template<class type>
+void AVL<type> :: childHeights(Node<type> *node, int height, int &lHeight, int &rHeight)
+{
+	lHeight = node->state == '>' ? height - 2 : height - 1;
+	rHeight = node->state == '<' ? height - 2 : height - 1;
+}
+
+template<class type>
+int AVL<type> :: link(Node<type> *node, Node<type> *left, int lHeight,
+                      Node<type> *right, int rHeight)
+{
+	node->left  = left;
+	node->right = right;
+	if (left)
+		left->parent = node;
+	if (right)
+		right->parent = node;
+
+	node->state = lHeight > rHeight ? '<' : (lHeight < rHeight ? '>' : '=');
+	return max(lHeight, rHeight) + 1;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - rotateLeft / rotateRight
+ * -----------------------------------------------------------------------------
+ * rotateLeft makes x the parent of a and y's left subtree, then y the parent
+ * of x and its own right subtree. rotateRight is the mirror image: y takes x's
+ * right subtree and c, then x takes its left subtree and y.
+ * -----------------------------------------------------------------------------
+ * return: the new subtree root, its height in height
+ ******************************************************************************/
+template<class type>
+Node<type>* AVL<type> :: rotateLeft(Node<type> *x, Node<type> *a, int ha,
+                                    Node<type> *y, int hy, int &height)
+{
+	int hb, hc;
+	Node<type> *b = y->left;
+	Node<type> *c = y->right;
+
+	childHeights(y, hy, hb, hc);
+	int hx = link(x, a, ha, b, hb);
+	height = link(y, x, hx, c, hc);
+	return y;
+}
+
+template<class type>
+Node<type>* AVL<type> :: rotateRight(Node<type> *y, Node<type> *x, int hx,
+                                     Node<type> *c, int hc, int &height)
+{
+	int ha, hb;
+	Node<type> *a = x->left;
+	Node<type> *b = x->right;
+
+	childHeights(x, hx, ha, hb);
+	int hy = link(y, b, hb, c, hc);
+	height = link(x, a, ha, y, hy);
+	return x;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - join
+ * -----------------------------------------------------------------------------
+ * This function joins two AVL subtrees whose keys are all below and all above
+ * the key of middle into one. When their heights differ by more than one, the
+ * middle node is hung on the spine of the taller subtree at the height of the
+ * shorter one and rotations repair the spine on the way back up, which costs
+ * O(difference in height).
+ * -----------------------------------------------------------------------------
+ * return: root of the joined subtree, its height in height
+ ******************************************************************************/
+template<class type>
+Node<type>* AVL<type> :: join(Node<type> *left, int lHeight, Node<type> *middle,
+                              Node<type> *right, int rHeight, int &height)
+{
+	if (lHeight > rHeight + 1)
+		return joinRight(left, lHeight, middle, right, rHeight, height);
+	if (rHeight > lHeight + 1)
+		return joinLeft(left, lHeight, middle, right, rHeight, height);
+
+	height = link(middle, left, lHeight, right, rHeight);
+	return middle;
+}
+
+template<class type>
+Node<type>* AVL<type> :: joinRight(Node<type> *left, int lHeight, Node<type> *middle,
+                                   Node<type> *right, int rHeight, int &height)
+{
+	int hl, hc, hm;
+	Node<type> *l = left->left;
+	Node<type> *c = left->right;
+	Node<type> *spine;
+
+	childHeights(left, lHeight, hl, hc);
+
+	if (hc <= rHeight + 1)
+	{
+		hm = link(middle, c, hc, right, rHeight);
+		if (hm <= hl + 1)
+		{
+			height = link(left, l, hl, middle, hm);
+			return left;
+		}
+
+		// DOUBLE ROTATION - c is too high to hang under middle, so it rises
+		//                   to the top and splits its subtrees between them
+		int h1, h2;
+		Node<type> *c1 = c->left;
+		Node<type> *c2 = c->right;
+
+		childHeights(c, hc, h1, h2);
+		int hx = link(left, l, hl, c1, h1);
+		hm = link(middle, c2, h2, right, rHeight);
+		height = link(c, left, hx, middle, hm);
+		return c;
+	}
+
+	spine = joinRight(c, hc, middle, right, rHeight, hm);
+	if (hm <= hl + 1)
+	{
+		height = link(left, l, hl, spine, hm);
+		return left;
+	}
+	return rotateLeft(left, l, hl, spine, hm, height);
+}
+
+template<class type>
+Node<type>* AVL<type> :: joinLeft(Node<type> *left, int lHeight, Node<type> *middle,
+                                  Node<type> *right, int rHeight, int &height)
+{
+	int hc, hr, hm;
+	Node<type> *c = right->left;
+	Node<type> *r = right->right;
+	Node<type> *spine;
+
+	childHeights(right, rHeight, hc, hr);
+
+	if (hc <= lHeight + 1)
+	{
+		hm = link(middle, left, lHeight, c, hc);
+		if (hm <= hr + 1)
+		{
+			height = link(right, middle, hm, r, hr);
+			return right;
+		}
+
+		// DOUBLE ROTATION - mirror image of the one in joinRight
+		int h1, h2;
+		Node<type> *c1 = c->left;
+		Node<type> *c2 = c->right;
+
+		childHeights(c, hc, h1, h2);
+		hm = link(middle, left, lHeight, c1, h1);
+		int hx = link(right, c2, h2, r, hr);
+		height = link(c, middle, hm, right, hx);
+		return c;
+	}
+
+	spine = joinLeft(left, lHeight, middle, c, hc, hm);
+	if (hm <= hr + 1)
+	{
+		height = link(right, spine, hm, r, hr);
+		return right;
+	}
+	return rotateRight(right, spine, hm, r, hr, height);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - join2 / splitLast
+ * -----------------------------------------------------------------------------
+ * join2 joins two subtrees without a middle node by taking the last node of
+ * the left one as the middle. splitLast takes that node out.
+ * -----------------------------------------------------------------------------
+ * return: root of the result, its height in height
+ ******************************************************************************/
+template<class type>
+Node<type>* AVL<type> :: join2(Node<type> *left, int lHeight,
+                               Node<type> *right, int rHeight, int &height)
+{
+	if (!left)
+	{
+		height = rHeight;
+		return right;
+	}
+
+	Node<type> *last;
+	int restHeight;
+	Node<type> *rest = splitLast(left, lHeight, last, restHeight);
+	return join(rest, restHeight, last, right, rHeight, height);
+}
+
+template<class type>
+Node<type>* AVL<type> :: splitLast(Node<type> *node, int nodeHeight,
+                                   Node<type> *&last, int &height)
+{
+	int hl, hr, restHeight;
+
+	childHeights(node, nodeHeight, hl, hr);
+	if (!node->right)
+	{
+		last   = node;
+		height = hl;
+		return node->left;
+	}
+
+	Node<type> *rest = splitLast(node->right, hr, last, restHeight);
+	return join(node->left, hl, node, rest, restHeight, height);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - split
+ * -----------------------------------------------------------------------------
+ * This function splits a subtree into the keys below key and the keys above
+ * it. The path down to key is cut, and the pieces hanging off each side of it
+ * are joined back up, each node on the path serving as the middle of one
+ * join, in O(height) in all.
+ * -----------------------------------------------------------------------------
+ * return: the two sides and their heights, and in match the node holding key,
+ *         NULL if there is none. match keeps stale child pointers.
+ ******************************************************************************/
+template<class type>
+void AVL<type> :: split(Node<type> *node, int nodeHeight, int key,
+                        Node<type> *&left, int &lHeight, Node<type> *&match,
+                        Node<type> *&right, int &rHeight)
+{
+	if (!node)
+	{
+		left = right = match = NULL;
+		lHeight = rHeight = 0;
+		return;
+	}
+
+	int hl, hr, pieceHeight;
+	Node<type> *l = node->left;
+	Node<type> *r = node->right;
+	Node<type> *piece;
+
+	childHeights(node, nodeHeight, hl, hr);
+
+	if (key == node->id)
+	{
+		left  = l;
+		right = r;
+		match = node;
+		lHeight = hl;
+		rHeight = hr;
+	}
+	else if (key < node->id)
+	{
+		split(l, hl, key, left, lHeight, match, piece, pieceHeight);
+		right = join(piece, pieceHeight, node, r, hr, rHeight);
+	}
+	else
+	{
+		split(r, hr, key, piece, pieceHeight, match, right, rHeight);
+		left = join(l, hl, node, piece, pieceHeight, lHeight);
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - remove
+ * -----------------------------------------------------------------------------
+ * This function unlinks the node holding key and deletes it. A node with two
+ * children is replaced by its in-order successor, which is unlinked from the
+ * bottom of the right subtree and takes over the node's children, parent and
+ * state, so no item is ever copied between nodes. The parent of the place
+ * that lost a level is marked with the side it lost, and removalBalance
+ * carries the change up from there.
+ * -----------------------------------------------------------------------------
+ * return: bool - if key was in the tree
+ ******************************************************************************/
+template<class type>
+bool AVL<type> :: remove(int key)
+{
+	Node<type> *node = root;
+
+	while (node && node->id != key)
+		node = key < node->id ? node->left : node->right;
+	if (!node)
+		return false;
+
+	Node<type> *p_node = node->parent;
+	Node<type> *shrunk;   // parent of the place that lost a level
+	char side;            // CALC - which of its sides that is
+
+	if (p_node)
+		p_node->path = p_node->left == node ? '<' : '>';
+
+	if (node->left && node->right)
+	{
+		Node<type> *next = node->right;
+		while (next->left)
+			next = next->left;
+
+		if (next == node->right)
+		{
+			shrunk = next;
+			side   = '>';
+		}
+		else
+		{
+			shrunk = next->parent;
+			side   = '<';
+			shrunk->left = next->right;
+			if (next->right)
+				next->right->parent = shrunk;
+			next->right = node->right;
+			next->right->parent = next;
+		}
+
+		next->left = node->left;
+		next->left->parent = next;
+		next->state = node->state;
+		attachNode(p_node, next);
+	}
+	else
+	{
+		Node<type> *child = node->left ? node->left : node->right;
+
+		shrunk = p_node;
+		side   = p_node ? p_node->path : '=';
+		if (child)
+			attachNode(p_node, child);
+		else if (p_node)
+			(p_node->steppedLeft() ? p_node->left : p_node->right) = NULL;
+		else
+			root = NULL;
+	}
+
+	delete node;
+	if (shrunk)
+	{
+		shrunk->path = side;
+		removalBalance(shrunk);
+	}
+	return true;
+}
+
+/*******************************************************************************
+ * FUNCTION - find / findNode
+ * -----------------------------------------------------------------------------
+ * These functions search the AVL tree for the node with the given key.
+ * findNode hands back the node itself, for containers that keep links in
+ * their items.
+ * -----------------------------------------------------------------------------
+ * return: pointer to the item or node stored under key, NULL if it is not
+ *         contained
+ ******************************************************************************/
+template<class type>
+type* AVL<type> :: find(int key)
+{
+	Node<type> *node = findNode(key);
+	return node ? &node->item : NULL;
+}
+
+template<class type>
+Node<type>* AVL<type> :: findNode(int key)
+{
+	Node<type> *next = root;
+
+	while (next)
+	{
+		if (key < next->id)
+			next = next->left;
+		else if (key > next->id)
+			next = next->right;
+		else
+			return next;
+	}
+	return NULL;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - begin / end
+ * -----------------------------------------------------------------------------
+ * Iterators over the tree in key order. end() is the NULL node.
+ ******************************************************************************/
+template<class type>
+AVLIter<type> AVL<type> :: begin()
+{
+	Node<type> *node = root;
+
+	while (node && node->left)
+		node = node->left;
+	return AVLIter<type>(node);
+}
+
+template<class type>
+AVLIter<type> AVL<type> :: end()
+{
+	return AVLIter<type>(NULL);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - lowerBound
+ * -----------------------------------------------------------------------------
+ * This function finds the first node whose key is not less than the given key.
+ * -----------------------------------------------------------------------------
+ * return: iterator at that node, end() if every key is smaller
+ ******************************************************************************/
+template<class type>
+AVLIter<type> AVL<type> :: lowerBound(int key)
+{
+	Node<type> *next = root;
+	Node<type> *bound = NULL;
+
+	while (next)
+	{
+		if (key <= next->id)
+		{
+			bound = next;
+			next = next->left;
+		}
+		else
+			next = next->right;
+	}
+	return AVLIter<type>(bound);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - upperBound
+ * -----------------------------------------------------------------------------
+ * This function finds the first node whose key is greater than the given key.
+ * -----------------------------------------------------------------------------
+ * return: iterator at that node, end() if no key is greater
+ ******************************************************************************/
+template<class type>
+AVLIter<type> AVL<type> :: upperBound(int key)
+{
+	Node<type> *next = root;
+	Node<type> *bound = NULL;
+
+	while (next)
+	{
+		if (key < next->id)
+		{
+			bound = next;
+			next = next->left;
+		}
+		else
+			next = next->right;
+	}
+	return AVLIter<type>(bound);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - range / forRange / countRange
+ * -----------------------------------------------------------------------------
+ * One descent finds the first key not below lo, and the walk then steps from
+ * successor to successor until it passes hi. Subtrees wholly outside the range
+ * are never entered, so a range of k keys costs O(log n + k).
+ * -----------------------------------------------------------------------------
+ * return: range - iterators at the first key in range and one past the last,
+ *         equal if the range is empty
+ ******************************************************************************/
+template<class type>
+pair<AVLIter<type>, AVLIter<type> > AVL<type> :: range(int lo, int hi)
+{
+	if (lo > hi)
+		return make_pair(end(), end());
+	return make_pair(lowerBound(lo), upperBound(hi));
+}
+
+template<class type>
+template<class Visit>
+void AVL<type> :: forRange(int lo, int hi, Visit visit)
+{
+	for (AVLIter<type> it = lowerBound(lo); it != end() && it.id() <= hi; ++it)
+		visit(it.id(), *it);
+}
+
+template<class type>
+long AVL<type> :: countRange(int lo, int hi)
+{
+	long count = 0;
+
+	for (AVLIter<type> it = lowerBound(lo); it != end() && it.id() <= hi; ++it)
+		++count;
+	return count;
+}
 
 
 /*******************************************************************************
- * FUNCTION - insert
+ * FUNCTION - removeRange
  * -----------------------------------------------------------------------------
- * This function attempts to insert a node into the AVL tree.
+ * This function cuts the keys in [lo, hi] out of the tree with two splits and
+ * joins what is left back together, which rebalances the tree in O(log n)
+ * however many keys go. Freeing the k removed nodes is the O(k) part.
  * -----------------------------------------------------------------------------
- * return: bool - if the insertion was a success
+ * return: number of keys removed
  ******************************************************************************/
 template<class type>
-bool AVL<type> :: insert(int id, type item)
+long AVL<type> :: removeRange(int lo, int hi)
 {
-	if (!root)
-	{
-		root = new Node<type>(id, item);
-		return true;
-	}
-	else
-	{
-		Node<type> *p_node = findLeafNode(id);
-		if (p_node)
-		{
-			attachNode(p_node, new Node<type>(id, item));
-			insertionUpdate(p_node);
-			return true;
-		}
-		return false;
-	}
-}
+	AVL<type> middle;
+	AVL<type> upper;
+	long removed = 0;
+
+	if (lo > hi)
+		return 0;
+
+	splitOff(lo, middle);
+	if (hi < INT_MAX)
+		middle.splitOff(hi + 1, upper);
+
+	for (AVLIter<type> it = middle.begin(); it != middle.end(); ++it)
+		++removed;
+	middle.clear();
 
+	concat(upper);
+	return removed;
+}
 
 /*******************************************************************************
  * FUNCTION - findLeafNode
@@ -83,17 +1224,22 @@ bool AVL<type> :: insert(int id, type item)
  * insert a node with the given key to.
  * -----------------------------------------------------------------------------
  * return: Leaf node corresponding to key, NULL if the node is contained
- * 		   already.
+ * 		   already, in which case match is set to it when given.
  ******************************************************************************/
 template<class type>
-Node<type>* AVL<type> :: findLeafNode(int key)
+Node<type>* AVL<type> :: findLeafNode(int key, Node<type> **match)
 {
 	Node<type> *next = root;
-	Node<type> *p_node;
+	Node<type> *p_node = NULL;
+	int depth = 0;
+
+	if (match)
+		*match = NULL;
 
 	while (next)
 	{
 		p_node = next;
+		++depth;
 		if (key < next->id)
 		{
 			next->path = '<';
@@ -105,8 +1251,14 @@ Node<type>* AVL<type> :: findLeafNode(int key)
 			next = next->right;
 		}
 		else
+		{
+			AVL_DEPTH(depth);
+			if (match)
+				*match = next;
 			return NULL;
+		}
 	}
+	AVL_DEPTH(depth);
 	return p_node;
 }
 
@@ -142,12 +1294,16 @@ void AVL<type> :: insertionUpdate(Node<type> *next)
 {
 	while (next && next->balanced())
 	{
+		AVL_COUNT(UPDATE_NODES);
 		next->state = next->path;
 		next = next->parent;
 	}
 
 	if (next)
+	{
+		AVL_COUNT(UPDATE_NODES);
 		balance(next);
+	}
 }
 
 
@@ -183,6 +1339,7 @@ void AVL<type> :: balance(Node<type> *node)
 template<class type>
 Node<type>* AVL<type> :: balance00(Node<type> *node)
 {
+	AVL_COUNT(BALANCE00);
 	first = node;
 	second = node->left;
 	third = second->left;
@@ -214,6 +1371,7 @@ Node<type>* AVL<type> :: balance00(Node<type> *node)
 template<class type>
 Node<type>* AVL<type> :: balance01(Node<type> *node)
 {
+	AVL_COUNT(BALANCE01);
 	first = node;
 	second = node->left;
 	third = second->right;
@@ -263,6 +1421,7 @@ Node<type>* AVL<type> :: balance01(Node<type> *node)
 template<class type>
 Node<type>* AVL<type> :: balance10(Node<type> *node)
 {
+	AVL_COUNT(BALANCE10);
 	first = node;
 	second = node->right;
 	third = second->left;
@@ -313,6 +1472,7 @@ Node<type>* AVL<type> :: balance10(Node<type> *node)
 template<class type>
 Node<type>* AVL<type> :: balance11(Node<type> *node)
 {
+	AVL_COUNT(BALANCE11);
 	first = node;
 	second = node->right;
 	third = second->right;
@@ -335,4 +1495,546 @@ Node<type>* AVL<type> :: balance11(Node<type> *node)
 }
 
 
+/*******************************************************************************
+ * FUNCTION - removalBalance
+ * -----------------------------------------------------------------------------
+ * This function starts at a node whose path side has lost a level and walks
+ * up until a subtree keeps its height. A balanced node only tips to its other
+ * side; a node heavy on the side that shrank becomes balanced and passes the
+ * loss to its parent. A node heavy on the other side is rotated: once when
+ * its sibling leans outwards or not at all, twice when it leans inwards.
+ * Only the rotation about a balanced sibling leaves the height unchanged, so
+ * unlike insertion a removal may rotate at every level on the way up.
+ ******************************************************************************/
+template<class type>
+void AVL<type> :: removalBalance(Node<type> *node)
+{
+	while (node)
+	{
+		char lost  = node->path;
+		char other = lost == '<' ? '>' : '<';
+
+		AVL_COUNT(UPDATE_NODES);
+		if (node->balanced())
+		{
+			node->state = other;
+			return;
+		}
+
+		if (node->doubleHeavy())
+			node->state = '=';
+		else
+		{
+			Node<type> *sibling = lost == '<' ? node->right : node->left;
+
+			if (sibling->state != lost)
+			{
+				AVL_COUNT(lost == '<' ? BALANCE11 : BALANCE00);
+				rotateUp(sibling);
+				if (sibling->balanced())
+				{
+					node->state    = other;
+					sibling->state = lost;
+					return;
+				}
+				node->state    = '=';
+				sibling->state = '=';
+				node = sibling;
+			}
+			else
+			{
+				Node<type> *inner = lost == '<' ? sibling->left : sibling->right;
+
+				AVL_COUNT(lost == '<' ? BALANCE10 : BALANCE01);
+				rotateUp(inner);
+				rotateUp(inner);
+				node->state    = inner->state == other ? lost : '=';
+				sibling->state = inner->state == lost ? other : '=';
+				inner->state   = '=';
+				node = inner;
+			}
+		}
+
+		// CLIMB - the subtree under node is a level shorter
+		Node<type> *p_node = node->parent;
+		if (p_node)
+			p_node->path = p_node->left == node ? '<' : '>';
+		node = p_node;
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - rotateUp
+ * -----------------------------------------------------------------------------
+ * This function rotates child above its parent, which takes over the child's
+ * inner subtree. States are left to the caller.
+ ******************************************************************************/
+template<class type>
+void AVL<type> :: rotateUp(Node<type> *child)
+{
+	Node<type> *node   = child->parent;
+	Node<type> *p_node = node->parent;
+
+	if (p_node)
+		p_node->path = p_node->left == node ? '<' : '>';
+	attachNode(p_node, child);
+
+	if (child == node->left)
+	{
+		node->left = child->right;
+		if (node->left)
+			node->left->parent = node;
+		child->right = node;
+	}
+	else
+	{
+		node->right = child->left;
+		if (node->right)
+			node->right->parent = node;
+		child->left = node;
+	}
+	node->parent = child;
+}
+
+/*******************************************************************************
+ * FUNCTION - parallelForEach
+ * -----------------------------------------------------------------------------
+ * Calls visit(id, item) once for every node. The subtrees of nodes more than
+ * PARALLEL_LEVELS high are visited as separate tasks, so visit is called from
+ * several threads at once and must be safe to call that way. Each task visits
+ * its own nodes in key order, but the tasks run in no particular order.
+ ******************************************************************************/
+template<class type>
+template<class Visit>
+void AVL<type> :: parallelForEach(Visit visit, ForkJoin &pool)
+{
+	forEachSubtree(root, stateHeight(root), visit, pool);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - parallelReduce
+ * -----------------------------------------------------------------------------
+ * Maps every node to map(id, item) and folds the results together with
+ * combine in key order, with the subtrees near the root folded in parallel.
+ * combine need only be associative, not commutative: the result is always
+ *
+ *     combine(... combine(combine(init, first), second) ..., last)
+ *
+ * as long as init is an identity of combine, since every task starts its
+ * fold from init. An empty tree gives init.
+ ******************************************************************************/
+template<class type>
+template<class Result, class Map, class Combine>
+Result AVL<type> :: parallelReduce(Result init, Map map, Combine combine, ForkJoin &pool)
+{
+	return reduceSubtree(root, stateHeight(root), init, map, combine, pool);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - visitSubtree
+ * -----------------------------------------------------------------------------
+ * An in-order walk of the subtree under top that climbs back through parent
+ * pointers instead of keeping a stack, and stops when it climbs out of top.
+ ******************************************************************************/
+template<class type>
+template<class Visit>
+void AVL<type> :: visitSubtree(Node<type> *top, Visit &visit)
+{
+	Node<type> *node = top;
+
+	if (!node)
+		return;
+	while (node->left)
+		node = node->left;
+
+	while (true)
+	{
+		visit(node->id, node->item);
+
+		if (node->right)
+		{
+			node = node->right;
+			while (node->left)
+				node = node->left;
+			continue;
+		}
+
+		// CLIMB - past every node whose right subtree is done
+		while (node != top && node == node->parent->right)
+			node = node->parent;
+		if (node == top)
+			return;
+		node = node->parent;
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - forEachSubtree / reduceSubtree
+ * -----------------------------------------------------------------------------
+ * Above PARALLEL_LEVELS both subtrees become tasks; below it the subtree is
+ * walked on the calling thread. reduceSubtree folds the node's own value in
+ * between the results of its subtrees to keep key order.
+ ******************************************************************************/
+template<class type>
+template<class Visit>
+void AVL<type> :: forEachSubtree(Node<type> *node, int height, Visit &visit,
+                                 ForkJoin &pool)
+{
+	if (height <= PARALLEL_LEVELS)
+	{
+		visitSubtree(node, visit);
+		return;
+	}
+
+	int hl, hr;
+	childHeights(node, height, hl, hr);
+	pool.invoke([&]() { forEachSubtree(node->left,  hl, visit, pool); },
+	            [&]() { forEachSubtree(node->right, hr, visit, pool); });
+	visit(node->id, node->item);
+}
+
+template<class type>
+template<class Result, class Map, class Combine>
+Result AVL<type> :: reduceSubtree(Node<type> *node, int height, const Result &init,
+                                  Map &map, Combine &combine, ForkJoin &pool)
+{
+	if (height <= PARALLEL_LEVELS)
+	{
+		Result total = init;
+		auto fold = [&](int id, type &item) { total = combine(total, map(id, item)); };
+		visitSubtree(node, fold);
+		return total;
+	}
+
+	int hl, hr;
+	Result left = init, right = init;
+	childHeights(node, height, hl, hr);
+	pool.invoke([&]() { left  = reduceSubtree(node->left,  hl, init, map, combine, pool); },
+	            [&]() { right = reduceSubtree(node->right, hr, init, map, combine, pool); });
+	return combine(combine(left, map(node->id, node->item)), right);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - stats
+ * -----------------------------------------------------------------------------
+ * This function measures the shape of the tree in one iterative walk that
+ * climbs back through parent pointers, so it needs no stack and allocates
+ * nothing. The walk carries the depth and the cache lines of the path down to
+ * the current node; summed over every node, these give the cost of a
+ * successful search for each key.
+ *
+ * bytesPerNode comes from nodeBytes, so every node is assumed to carry the
+ * same allocator overhead.
+ * -----------------------------------------------------------------------------
+ * return: AVLStats - the measurements, all zero for an empty tree
+ ******************************************************************************/
+template<class type>
+AVLStats AVL<type> :: stats()
+{
+	AVLStats stats = AVLStats();
+	Node<type> *node  = root;
+	Node<type> *prev  = NULL;
+	int         depth = 0;
+	long        lines = 0;
+	long        depthSum = 0;
+	long        lineSum  = 0;
+
+	if (!root)
+		return stats;
+
+	while (node)
+	{
+		// ENTER - arrived from the parent, count the node
+		if (prev == node->parent)
+		{
+			++depth;
+			lines += linesOf(node);
+
+			++stats.count;
+			depthSum += depth;
+			lineSum  += lines;
+			stats.height = max(stats.height, depth);
+
+			if (node->state == '<')
+				++stats.leftHeavy;
+			else if (node->state == '>')
+				++stats.rightHeavy;
+			else
+				++stats.balanced;
+
+			prev = node;
+			if (node->left)
+			{
+				node = node->left;
+				continue;
+			}
+			if (node->right)
+			{
+				node = node->right;
+				continue;
+			}
+		}
+		// TURN - back from the left subtree, walk the right one
+		else if (prev == node->left && node->right)
+		{
+			prev = node;
+			node = node->right;
+			continue;
+		}
+
+		// CLIMB - both subtrees are done
+		--depth;
+		lines -= linesOf(node);
+		prev = node;
+		node = node->parent;
+	}
+
+	stats.minHeight      = (int)ceil(log2((double)stats.count + 1));
+	stats.heightBound    = 1.4405 * log2((double)stats.count + 2) - 0.3277;
+	stats.averageDepth   = (double)depthSum / stats.count;
+	stats.linesPerLookup = (double)lineSum / stats.count;
+	stats.bytesPerNode   = nodeBytes();
+	stats.bytes          = stats.bytesPerNode * stats.count;
+	return stats;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - nodeBytes
+ * -----------------------------------------------------------------------------
+ * glibc sizes a block by the bytes asked for, so the overhead of a node is
+ * read from a probe block of the same size. Elsewhere it is sizeof(Node).
+ * -----------------------------------------------------------------------------
+ * return: bytes one node takes, allocator overhead included
+ ******************************************************************************/
+template<class type>
+long AVL<type> :: nodeBytes()
+{
+#ifdef __GLIBC__
+	void *probe = ::operator new(sizeof(Node<type>));
+	long  bytes = malloc_usable_size(probe) + sizeof(size_t);
+
+	::operator delete(probe);
+	return bytes;
+#else
+	return sizeof(Node<type>);
+#endif
+}
+
+
+/*******************************************************************************
+ * FUNCTION - linesOf
+ * -----------------------------------------------------------------------------
+ * return: cache lines the node's bytes span
+ ******************************************************************************/
+template<class type>
+int AVL<type> :: linesOf(Node<type> *node)
+{
+	size_t first = (size_t)node / CACHE_LINE;
+	size_t last  = ((size_t)node + sizeof(Node<type>) - 1) / CACHE_LINE;
+
+	return (int)(last - first + 1);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - validate
+ * -----------------------------------------------------------------------------
+ * This function checks the whole tree in one iterative pass: each node's
+ * state must match the real heights of its children, keys must come out of
+ * the in-order walk strictly ascending and every child must point back to its
+ * parent. The walk keeps a fixed stack of MAX_HEIGHT frames, so it allocates
+ * nothing, and it stops at the first broken node.
+ * -----------------------------------------------------------------------------
+ * return: bool - if the tree is a valid AVL tree
+ ******************************************************************************/
+template<class type>
+bool AVL<type> :: validate()
+{
+	struct Frame
+	{
+		Node<type> *node;
+		int lHeight; // CALC - height of the left subtree once walked
+		int stage;   // CALC - 0 descend left, 1 visit and descend right, 2 done
+	};
+
+	Frame stack[MAX_HEIGHT];
+	int   top = 0;
+	int   childHeight = 0;
+	bool  visited = false;
+	int   lastId = 0;
+
+	if (!root)
+		return true;
+	if (root->parent)
+		return false;
+
+	stack[top].node  = root;
+	stack[top].stage = 0;
+	++top;
+
+	while (top > 0)
+	{
+		Frame &frame = stack[top - 1];
+		Node<type> *node = frame.node;
+		Node<type> *child = NULL;
+
+		if (frame.stage == 0)
+		{
+			frame.stage = 1;
+			child = node->left;
+			childHeight = 0;
+		}
+		else if (frame.stage == 1)
+		{
+			// in-order visit, with the left subtree's height in hand
+			frame.lHeight = childHeight;
+			if (visited && node->id <= lastId)
+				return false;
+			visited = true;
+			lastId  = node->id;
+
+			frame.stage = 2;
+			child = node->right;
+			childHeight = 0;
+		}
+		else
+		{
+			if (!stateMatches(node->state, frame.lHeight, childHeight))
+				return false;
+			childHeight = max(frame.lHeight, childHeight) + 1;
+			--top;
+			continue;
+		}
+
+		if (child)
+		{
+			if (child->parent != node || top == MAX_HEIGHT)
+				return false;
+			stack[top].node  = child;
+			stack[top].stage = 0;
+			++top;
+		}
+	}
+	return true;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - validatePath
+ * -----------------------------------------------------------------------------
+ * This function checks the path from the node with the given key up to the
+ * root, together with both children of every node on it. An insertion
+ * changes states only on that path, and a rotation moves at most one node
+ * off it, a child of the subtree's new root, so this covers every node an
+ * insertion of the key can disturb. Each of those nodes has its parent and
+ * child links, its children's key order and its state checked, and the key
+ * must lie on the correct side of every ancestor. The subtrees below them are
+ * trusted, so their heights are read off their states in O(log n) each,
+ * which keeps the check at O(log^2 n) per call instead of a full O(n) pass.
+ * -----------------------------------------------------------------------------
+ * return: bool - if the key is contained and its path is valid
+ ******************************************************************************/
+template<class type>
+bool AVL<type> :: validatePath(int id)
+{
+	Node<type> *node = root;
+
+	while (node && node->id != id)
+		node = (id < node->id) ? node->left : node->right;
+	if (!node)
+		return false;
+
+	for (int steps = 0; node; ++steps)
+	{
+		Node<type> *p_node = node->parent;
+
+		if (steps == MAX_HEIGHT)
+			return false;
+
+		if (!nodeValid(node) || (node->left && !nodeValid(node->left))
+		                     || (node->right && !nodeValid(node->right)))
+			return false;
+
+		if (p_node)
+		{
+			if (p_node->left == node)
+			{
+				if (id >= p_node->id)
+					return false;
+			}
+			else if (p_node->right != node || id <= p_node->id)
+				return false;
+		}
+		else if (node != root)
+			return false;
+
+		node = p_node;
+	}
+	return true;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - nodeValid
+ * -----------------------------------------------------------------------------
+ * return: bool - if node's children point back to it, sit on the correct
+ *                side of it and have the heights its state records
+ ******************************************************************************/
+template<class type>
+bool AVL<type> :: nodeValid(Node<type> *node)
+{
+	if (node->left && (node->left->parent != node || node->left->id >= node->id))
+		return false;
+	if (node->right && (node->right->parent != node || node->right->id <= node->id))
+		return false;
+	return stateMatches(node->state, stateHeight(node->left), stateHeight(node->right));
+}
+
+
+/*******************************************************************************
+ * FUNCTION - stateMatches
+ * -----------------------------------------------------------------------------
+ * return: bool - if state describes children of the given heights
+ ******************************************************************************/
+template<class type>
+bool AVL<type> :: stateMatches(char state, int lHeight, int rHeight)
+{
+	switch (state)
+	{
+	case '<': return lHeight == rHeight + 1;
+	case '=': return lHeight == rHeight;
+	case '>': return rHeight == lHeight + 1;
+	default:  return false;
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - stateHeight
+ * -----------------------------------------------------------------------------
+ * Follows the heavier child down from node. When the states below are
+ * correct this is a longest path, so its length is the subtree height.
+ * -----------------------------------------------------------------------------
+ * return: height of the subtree at node as recorded by the states
+ ******************************************************************************/
+template<class type>
+int AVL<type> :: stateHeight(Node<type> *node)
+{
+	int height = 0;
+
+	while (node && height < MAX_HEIGHT)
+	{
+		++height;
+		node = node->rightHeavy() ? node->right : node->left;
+	}
+	return height;
+}
+
+
 #endif /* AVL_H_ */
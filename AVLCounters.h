@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef AVLCOUNTERS_H_
+#define AVLCOUNTERS_H_
+
+#include <iostream>
+using namespace std;
+
+
+/*******************************************************************************
+ * INSTRUMENTATION MACROS
+ * -----------------------------------------------------------------------------
+ * The AVL hot path is instrumented through these macros. Unless the build
+ * defines AVL_INSTRUMENT they expand to nothing, so the counters cost no code
+ * at all. With it, each event is a relaxed load and store on a counter owned
+ * by the calling thread.
+ ******************************************************************************/
+#ifdef AVL_INSTRUMENT
+#define AVL_COUNT(counter)      AVLCounters::add(counter, 1)
+#define AVL_COUNT_N(counter, n) AVLCounters::add(counter, n)
+#define AVL_DEPTH(depth)        AVLCounters::depth(depth)
+#else
+#define AVL_COUNT(counter)      ((void)0)
+#define AVL_COUNT_N(counter, n) ((void)(n))
+#define AVL_DEPTH(depth)        ((void)(depth))
+#endif
+
+
+/*******************************************************************************
+ * ENUM AVLCounter
+ * -----------------------------------------------------------------------------
+ * The events counted on the AVL hot path.
+ ******************************************************************************/
+enum AVLCounter
+{
+	BALANCE00,     // left-left rotations
+	BALANCE01,     // left-right rotations
+	BALANCE10,     // right-left rotations
+	BALANCE11,     // right-right rotations
+	UPDATE_NODES,  // nodes visited by insertionUpdate
+	DESCENTS,      // searches for an insertion leaf
+	DESCENT_STEPS, // nodes stepped through by those searches
+	ALLOCATIONS,   // nodes allocated
+	COUNTER_COUNT
+};
+
+
+#ifdef AVL_INSTRUMENT
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+
+/*******************************************************************************
+ * CLASS - AVLCounters
+ * -----------------------------------------------------------------------------
+ * This class keeps one block of counters per thread, so recording an event
+ * never contends with another thread. Blocks are registered when a thread
+ * first counts something and are summed when the counters are read. A block
+ * outlives its thread so that its counts stay in the totals.
+ ******************************************************************************/
+class AVLCounters
+{
+public:
+
+	// descents deeper than this share the last histogram bucket
+	static const int DEPTH_BUCKETS = 64;
+
+	struct Snapshot
+	{
+		long counters[COUNTER_COUNT];
+		long depths[DEPTH_BUCKETS];
+	};
+
+	static void add(AVLCounter counter, long n);
+		// adds n to counter for the calling thread
+
+	static void depth(int depth);
+		// records one descent of the given length
+
+	static Snapshot read();
+		// sums the counters of every thread
+
+	static void reset();
+		// zeroes the counters of every thread
+
+	static void writeJson(ostream& out);
+		// writes the summed counters as one JSON object
+
+private:
+
+	struct Block
+	{
+		atomic<long> counters[COUNTER_COUNT];
+		atomic<long> depths[DEPTH_BUCKETS];
+	};
+
+	static Block& local();
+	static void bump(atomic<long> &c, long n);
+	static mutex& registryLock();
+	static vector<Block*>& registry();
+};
+
+
+inline mutex& AVLCounters :: registryLock()
+{
+	static mutex lock;
+	return lock;
+}
+
+inline vector<AVLCounters::Block*>& AVLCounters :: registry()
+{
+	static vector<Block*> blocks;
+	return blocks;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - local
+ * -----------------------------------------------------------------------------
+ * return: the calling thread's block, registering it on first use
+ ******************************************************************************/
+inline AVLCounters::Block& AVLCounters :: local()
+{
+	static thread_local Block *block = NULL;
+
+	if (!block)
+	{
+		block = new Block;
+		for (int i = 0; i < COUNTER_COUNT; ++i)
+			block->counters[i].store(0, memory_order_relaxed);
+		for (int i = 0; i < DEPTH_BUCKETS; ++i)
+			block->depths[i].store(0, memory_order_relaxed);
+
+		lock_guard<mutex> guard(registryLock());
+		registry().push_back(block);
+	}
+	return *block;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - bump
+ * -----------------------------------------------------------------------------
+ * Only the owning thread writes a block, so a relaxed load and store is enough
+ * and avoids the locked read-modify-write of fetch_add.
+ ******************************************************************************/
+inline void AVLCounters :: bump(atomic<long> &c, long n)
+{
+	c.store(c.load(memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+inline void AVLCounters :: add(AVLCounter counter, long n)
+{
+	bump(local().counters[counter], n);
+}
+
+inline void AVLCounters :: depth(int depth)
+{
+	Block &block = local();
+
+	bump(block.counters[DESCENTS], 1);
+	bump(block.counters[DESCENT_STEPS], depth);
+	bump(block.depths[depth < DEPTH_BUCKETS ? depth : DEPTH_BUCKETS - 1], 1);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - read / reset
+ ******************************************************************************/
+inline AVLCounters::Snapshot AVLCounters :: read()
+{
+	Snapshot total = Snapshot();
+	lock_guard<mutex> guard(registryLock());
+
+	for (size_t b = 0; b < registry().size(); ++b)
+	{
+		Block *block = registry()[b];
+		for (int i = 0; i < COUNTER_COUNT; ++i)
+			total.counters[i] += block->counters[i].load(memory_order_relaxed);
+		for (int i = 0; i < DEPTH_BUCKETS; ++i)
+			total.depths[i] += block->depths[i].load(memory_order_relaxed);
+	}
+	return total;
+}
+
+inline void AVLCounters :: reset()
+{
+	lock_guard<mutex> guard(registryLock());
+
+	for (size_t b = 0; b < registry().size(); ++b)
+	{
+		Block *block = registry()[b];
+		for (int i = 0; i < COUNTER_COUNT; ++i)
+			block->counters[i].store(0, memory_order_relaxed);
+		for (int i = 0; i < DEPTH_BUCKETS; ++i)
+			block->depths[i].store(0, memory_order_relaxed);
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - writeJson
+ * -----------------------------------------------------------------------------
+ * Writes {"counters": {...}, "depth_histogram": [...]} where entry i of the
+ * histogram counts descents of length i. Trailing empty buckets are dropped.
+ ******************************************************************************/
+inline void AVLCounters :: writeJson(ostream& out)
+{
+	static const char *NAMES[COUNTER_COUNT] = {
+		"balance00", "balance01", "balance10", "balance11",
+		"update_nodes", "descents", "descent_steps", "allocations"
+	};
+	Snapshot total = read();
+	int last = DEPTH_BUCKETS;
+
+	while (last > 0 && total.depths[last - 1] == 0)
+		--last;
+
+	out << "{\"counters\": {";
+	for (int i = 0; i < COUNTER_COUNT; ++i)
+		out << (i ? ", " : "") << '"' << NAMES[i] << "\": " << total.counters[i];
+	out << "}, \"depth_histogram\": [";
+	for (int i = 0; i < last; ++i)
+		out << (i ? ", " : "") << total.depths[i];
+	out << "]}";
+}
+
+#endif /* AVL_INSTRUMENT */
+
+
+#endif /* AVLCOUNTERS_H_ */
@@ -0,0 +1,127 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef AVLITER_H_
+#define AVLITER_H_
+
+#include "Node.h"
+
+
+/*******************************************************************************
+ * CLASS - AVLIter
+ * -----------------------------------------------------------------------------
+ * This class walks the nodes of an AVL tree in key order. Successors are found
+ * through the parent pointers kept on each node, so the iterator holds nothing
+ * but the current node and a step costs amortized O(1). A NULL node marks the
+ * end of the tree.
+ ******************************************************************************/
+template<class type>
+class AVLIter
+{
+public:
+
+	AVLIter(Node<type> *node = NULL);
+
+	int id();
+		// POST: key of the current node
+
+	type get();
+		// POST: item of the current node
+
+	Node<type>* node();
+		// POST: the current node, NULL at the end
+
+	Node<type>* next();
+		// POST: moves to the in-order successor
+
+	type& operator *  ();
+	AVLIter<type>& operator ++ ();
+	bool  operator == (const AVLIter<type>& other) const;
+	bool  operator != (const AVLIter<type>& other) const;
+
+private:
+	Node<type> *ptr;
+};
+
+
+template<class type>
+AVLIter<type> :: AVLIter(Node<type> *node)
+{
+	ptr = node;
+}
+
+template<class type>
+int AVLIter<type> :: id()
+{
+	return ptr->id;
+}
+
+template<class type>
+type AVLIter<type> :: get()
+{
+	return ptr->item;
+}
+
+template<class type>
+Node<type>* AVLIter<type> :: node()
+{
+	return ptr;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - next
+ * -----------------------------------------------------------------------------
+ * The successor is the leftmost node of the right subtree when there is one,
+ * otherwise the first ancestor we reach while climbing up from a left child.
+ ******************************************************************************/
+template<class type>
+Node<type>* AVLIter<type> :: next()
+{
+	if (ptr->right)
+	{
+		ptr = ptr->right;
+		while (ptr->left)
+			ptr = ptr->left;
+	}
+	else
+	{
+		Node<type> *child = ptr;
+		ptr = ptr->parent;
+		while (ptr && ptr->right == child)
+		{
+			child = ptr;
+			ptr = ptr->parent;
+		}
+	}
+	return ptr;
+}
+
+template<class type>
+type& AVLIter<type> :: operator * ()
+{
+	return ptr->item;
+}
+
+template<class type>
+AVLIter<type>& AVLIter<type> :: operator ++ ()
+{
+	next();
+	return *this;
+}
+
+template<class type>
+bool AVLIter<type> :: operator == (const AVLIter<type>& other) const
+{
+	return ptr == other.ptr;
+}
+
+template<class type>
+bool AVLIter<type> :: operator != (const AVLIter<type>& other) const
+{
+	return ptr != other.ptr;
+}
+
+
+#endif /* AVLITER_H_ */
@@ -0,0 +1,428 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef AVLMULTIMAP_H_
+#define AVLMULTIMAP_H_
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include "AVL.h"
+#include "AVLIter.h"
+using namespace std;
+
+
+/*******************************************************************************
+ * CLASS - ValueBucket
+ * -----------------------------------------------------------------------------
+ * This class holds the values stored under one key, in the order they were
+ * added. The first INLINE values live inside the bucket itself, so a key with
+ * only a few values costs no allocation beyond its tree node. Later values go
+ * into chunks of CHUNK values each, found through a table of chunk pointers
+ * that doubles as it fills. Chunks never move, so a reference to a value
+ * stays good while more values are added.
+ ******************************************************************************/
+template<class type, int INLINE = 4>
+class ValueBucket
+{
+public:
+
+	class iterator;
+
+	ValueBucket();
+	ValueBucket(const ValueBucket<type, INLINE>& other);
+	ValueBucket<type, INLINE>& operator = (const ValueBucket<type, INLINE>& other);
+	~ValueBucket();
+
+	void push(const type& item);
+		// POST: item added after every value already in the bucket
+
+	void erase(long i);
+		// PRE:  0 <= i < size()
+		// POST: value at i removed, the values after it moved down one
+
+	long size() const;
+	type& operator [] (long i);
+	const type& operator [] (long i) const;
+		// PRE: 0 <= i < size()
+
+	void clear();
+		// POST: bucket is empty and has released its chunks
+
+	iterator begin();
+	iterator end();
+
+private:
+
+	static const int CHUNK = 32;
+
+	long   count;          // CALC - values in the bucket
+	type   inlined[INLINE];
+	type **chunks;         // POINT - to the table of spilled chunks, or NULL
+	long   chunkSlots;     // CALC - size of the chunk table
+};
+
+
+/*******************************************************************************
+ * CLASS - ValueBucket::iterator
+ * -----------------------------------------------------------------------------
+ * A bucket and a position in it. A default iterator is the empty range that
+ * AVLMultimap::equal_range gives for a missing key.
+ ******************************************************************************/
+template<class type, int INLINE>
+class ValueBucket<type, INLINE>::iterator
+{
+public:
+
+	typedef forward_iterator_tag iterator_category;
+	typedef type                 value_type;
+	typedef ptrdiff_t            difference_type;
+	typedef type*                pointer;
+	typedef type&                reference;
+
+	iterator(ValueBucket<type, INLINE> *bucket = NULL, long at = 0)
+		: bucket(bucket), at(at) {}
+
+	type& operator *  ()      { return (*bucket)[at]; }
+	type* operator -> ()      { return &(*bucket)[at]; }
+	iterator& operator ++ ()  { ++at; return *this; }
+	iterator  operator ++ (int) { iterator old = *this; ++at; return old; }
+
+	bool operator == (const iterator& other) const
+		{ return bucket == other.bucket && at == other.at; }
+	bool operator != (const iterator& other) const
+		{ return !(*this == other); }
+
+private:
+	ValueBucket<type, INLINE> *bucket;
+	long at;
+};
+
+
+template<class type, int INLINE>
+ValueBucket<type, INLINE> :: ValueBucket()
+{
+	count      = 0;
+	chunks     = NULL;
+	chunkSlots = 0;
+}
+
+template<class type, int INLINE>
+ValueBucket<type, INLINE> :: ValueBucket(const ValueBucket<type, INLINE>& other)
+{
+	count      = 0;
+	chunks     = NULL;
+	chunkSlots = 0;
+	*this = other;
+}
+
+template<class type, int INLINE>
+ValueBucket<type, INLINE>& ValueBucket<type, INLINE> :: operator = (const ValueBucket<type, INLINE>& other)
+{
+	if (&other == this)
+		return *this;
+
+	clear();
+	for (long i = 0; i < other.count; ++i)
+		push(other[i]);
+	return *this;
+}
+
+template<class type, int INLINE>
+ValueBucket<type, INLINE> :: ~ValueBucket()
+{
+	clear();
+}
+
+template<class type, int INLINE>
+long ValueBucket<type, INLINE> :: size() const
+{
+	return count;
+}
+
+template<class type, int INLINE>
+type& ValueBucket<type, INLINE> :: operator [] (long i)
+{
+	if (i < INLINE)
+		return inlined[i];
+	i -= INLINE;
+	return chunks[i / CHUNK][i % CHUNK];
+}
+
+template<class type, int INLINE>
+const type& ValueBucket<type, INLINE> :: operator [] (long i) const
+{
+	if (i < INLINE)
+		return inlined[i];
+	i -= INLINE;
+	return chunks[i / CHUNK][i % CHUNK];
+}
+
+
+/*******************************************************************************
+ * METHOD push
+ * -----------------------------------------------------------------------------
+ * A new chunk is allocated each time the last one fills, and the chunk table
+ * doubles when it has no free slot for it.
+ ******************************************************************************/
+template<class type, int INLINE>
+void ValueBucket<type, INLINE> :: push(const type& item)
+{
+	if (count < INLINE)
+	{
+		inlined[count++] = item;
+		return;
+	}
+
+	long spilled = count - INLINE;
+	if (spilled % CHUNK == 0)
+	{
+		long chunk = spilled / CHUNK;
+		if (chunk == chunkSlots)
+		{
+			long   slots = chunkSlots ? 2 * chunkSlots : 4;
+			type **table = new type*[slots];
+			for (long i = 0; i < chunkSlots; ++i)
+				table[i] = chunks[i];
+			delete [] chunks;
+			chunks     = table;
+			chunkSlots = slots;
+		}
+		chunks[chunk] = new type[CHUNK];
+	}
+
+	chunks[spilled / CHUNK][spilled % CHUNK] = item;
+	++count;
+}
+
+/*******************************************************************************
+ * METHOD erase
+ * -----------------------------------------------------------------------------
+ * The values after i shift down one, so erasing the last value is O(1). A
+ * chunk left empty is released at once; the chunk table is kept.
+ ******************************************************************************/
+template<class type, int INLINE>
+void ValueBucket<type, INLINE> :: erase(long i)
+{
+	for (; i < count - 1; ++i)
+		(*this)[i] = (*this)[i + 1];
+	(*this)[count - 1] = type();
+	--count;
+
+	if (count >= INLINE && (count - INLINE) % CHUNK == 0)
+	{
+		delete [] chunks[(count - INLINE) / CHUNK];
+		chunks[(count - INLINE) / CHUNK] = NULL;
+	}
+}
+
+template<class type, int INLINE>
+void ValueBucket<type, INLINE> :: clear()
+{
+	long used = count > INLINE ? (count - INLINE + CHUNK - 1) / CHUNK : 0;
+
+	for (long i = 0; i < used; ++i)
+		delete [] chunks[i];
+	delete [] chunks;
+
+	count      = 0;
+	chunks     = NULL;
+	chunkSlots = 0;
+}
+
+template<class type, int INLINE>
+typename ValueBucket<type, INLINE>::iterator ValueBucket<type, INLINE> :: begin()
+{
+	return iterator(this, 0);
+}
+
+template<class type, int INLINE>
+typename ValueBucket<type, INLINE>::iterator ValueBucket<type, INLINE> :: end()
+{
+	return iterator(this, count);
+}
+
+
+/*******************************************************************************
+ * CLASS - AVLMultimap
+ * -----------------------------------------------------------------------------
+ * This class is an AVL tree that keeps every value inserted under a key. Each
+ * key has one node, and the node's item is the ValueBucket of the key's
+ * values, so duplicates add no nodes and the tree stays as short as the
+ * number of distinct keys allows. Looking up a key's values or their number
+ * is one descent, O(log n) in the number of distinct keys.
+ ******************************************************************************/
+template<class type>
+class AVLMultimap
+{
+public:
+
+	typedef ValueBucket<type>           Bucket;
+	typedef typename Bucket::iterator   iterator;
+
+	AVL<Bucket> tree;
+
+	AVLMultimap();
+
+	void insert(int id, const type& item);
+		// POST: item added after the values already under id
+
+	long count(int id);
+		// POST: number of values under id
+
+	pair<iterator, iterator> equal_range(int id);
+		// POST: the values under id in the order they were inserted, an
+		//       empty range if there are none
+
+	long size();
+		// POST: number of values under all keys
+
+	long keys();
+		// POST: number of distinct keys
+
+	bool erase(int id, const type& item);
+		// POST: the last value equal to item under id removed, and the key
+		//       with it if that was its last value; false if there was none
+
+	long removeRange(int lo, int hi);
+		// POST: every value under keys in [lo, hi] removed, returns how many
+
+	template<class Visit>
+	void forEach(Visit visit);
+		// POST: visit(id, item) called for every value, in key order and
+		//       then in insertion order
+
+	void clear();
+
+private:
+
+	// the tree owns its nodes, so copies are not allowed
+	AVLMultimap(const AVLMultimap<type>&);
+	AVLMultimap<type>& operator = (const AVLMultimap<type>&);
+
+	long values;    // CALC - values under all keys
+	long distinct;  // CALC - keys with at least one value
+};
+
+
+template<class type>
+AVLMultimap<type> :: AVLMultimap()
+{
+	values   = 0;
+	distinct = 0;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - insert
+ * -----------------------------------------------------------------------------
+ * One descent finds the key's node, or adds it with an empty bucket.
+ ******************************************************************************/
+template<class type>
+void AVLMultimap<type> :: insert(int id, const type& item)
+{
+	pair<Node<Bucket>*, bool> at = tree.findOrInsert(id);
+
+	if (at.second)
+		++distinct;
+	at.first->item.push(item);
+	++values;
+}
+
+template<class type>
+long AVLMultimap<type> :: count(int id)
+{
+	Bucket *bucket = tree.find(id);
+	return bucket ? bucket->size() : 0;
+}
+
+template<class type>
+pair<typename AVLMultimap<type>::iterator, typename AVLMultimap<type>::iterator>
+AVLMultimap<type> :: equal_range(int id)
+{
+	Bucket *bucket = tree.find(id);
+
+	if (!bucket)
+		return make_pair(iterator(), iterator());
+	return make_pair(bucket->begin(), bucket->end());
+}
+
+template<class type>
+long AVLMultimap<type> :: size()
+{
+	return values;
+}
+
+template<class type>
+long AVLMultimap<type> :: keys()
+{
+	return distinct;
+}
+
+template<class type>
+template<class Visit>
+void AVLMultimap<type> :: forEach(Visit visit)
+{
+	for (AVLIter<Bucket> it = tree.begin(); it != tree.end(); ++it)
+		for (iterator value = (*it).begin(); value != (*it).end(); ++value)
+			visit(it.id(), *value);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - erase
+ * -----------------------------------------------------------------------------
+ * The bucket is searched from its newest value back, so taking out a value
+ * just added, or emptying a bucket from the back, costs one descent.
+ ******************************************************************************/
+template<class type>
+bool AVLMultimap<type> :: erase(int id, const type& item)
+{
+	Bucket *bucket = tree.find(id);
+	long i = bucket ? bucket->size() - 1 : -1;
+
+	while (i >= 0 && !((*bucket)[i] == item))
+		--i;
+	if (i < 0)
+		return false;
+
+	bucket->erase(i);
+	--values;
+	if (bucket->size() == 0)
+	{
+		tree.remove(id);
+		--distinct;
+	}
+	return true;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - removeRange
+ * -----------------------------------------------------------------------------
+ * The buckets in range are walked once to count their values, and the tree
+ * then cuts them out with AVL::removeRange.
+ ******************************************************************************/
+template<class type>
+long AVLMultimap<type> :: removeRange(int lo, int hi)
+{
+	long removed = 0;
+
+	tree.forRange(lo, hi, [&](int, Bucket &bucket) { removed += bucket.size(); });
+	distinct -= tree.removeRange(lo, hi);
+	values   -= removed;
+	return removed;
+}
+
+template<class type>
+void AVLMultimap<type> :: clear()
+{
+	tree.clear();
+	values   = 0;
+	distinct = 0;
+}
+
+
+#endif /* AVLMULTIMAP_H_ */
@@ -0,0 +1,54 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef AVLSTATS_H_
+#define AVLSTATS_H_
+
+#include <iostream>
+using namespace std;
+
+
+/*******************************************************************************
+ * STRUCT - AVLStats
+ * -----------------------------------------------------------------------------
+ * The shape of one AVL tree as measured by AVL::stats. Depths count the nodes
+ * a successful search visits, so the root is at depth 1 and the deepest node
+ * is at the tree's height.
+ ******************************************************************************/
+struct AVLStats
+{
+	long   count;          // CALC - nodes in the tree
+	int    height;         // CALC - levels on the longest path
+	int    minHeight;      // CALC - fewest levels that hold count nodes
+	double heightBound;    // CALC - most levels an AVL tree of count nodes has
+	double averageDepth;   // CALC - nodes visited per successful search
+	long   leftHeavy;      // CALC - nodes in state '<'
+	long   balanced;       // CALC - nodes in state '='
+	long   rightHeavy;     // CALC - nodes in state '>'
+	long   bytesPerNode;   // CALC - node size with allocator overhead
+	long   bytes;          // CALC - bytesPerNode for every node
+	double linesPerLookup; // CALC - cache lines per successful search
+
+	void writeJson(ostream& out) const;
+		// writes the fields as one JSON object
+};
+
+
+inline void AVLStats :: writeJson(ostream& out) const
+{
+	out << "{\"count\": "            << count
+	    << ", \"height\": "          << height
+	    << ", \"min_height\": "      << minHeight
+	    << ", \"height_bound\": "    << heightBound
+	    << ", \"average_depth\": "   << averageDepth
+	    << ", \"states\": {\"<\": "  << leftHeavy
+	    << ", \"=\": "               << balanced
+	    << ", \">\": "               << rightHeavy
+	    << "}, \"bytes_per_node\": " << bytesPerNode
+	    << ", \"bytes\": "           << bytes
+	    << ", \"lines_per_lookup\": " << linesPerLookup << "}";
+}
+
+
+#endif /* AVLSTATS_H_ */
@@ -0,0 +1,547 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef BPTREE_H_
+#define BPTREE_H_
+
+#include <iostream>
+using namespace std;
+
+
+/*******************************************************************************
+ * STRUCT BPLeaf / BPInner
+ * -----------------------------------------------------------------------------
+ * The two node kinds of a BPTree. Leaves hold up to CAP sorted keys with their
+ * items in parallel arrays and are chained left to right, so a range scan
+ * walks contiguous memory. Inner nodes hold CAP separator keys, where
+ * child[i + 1] holds the keys not less than keys[i].
+ ******************************************************************************/
+template<class type, int CAP>
+struct BPLeaf
+{
+	int   count;      // CALC  - number of keys in use
+	int   keys[CAP];  // CALC  - sorted keys
+	type  items[CAP]; // CALC  - item stored under keys[i]
+	BPLeaf<type, CAP> *next; // POINT - to the leaf on the right
+};
+
+template<int CAP>
+struct BPInner
+{
+	int   count;          // CALC  - number of separator keys in use
+	int   keys[CAP];      // CALC  - sorted separator keys
+	void *child[CAP + 1]; // POINT - to inner nodes or leaves
+};
+
+
+/*******************************************************************************
+ * CLASS - BPTreeIter
+ * -----------------------------------------------------------------------------
+ * This class walks a BPTree in key order, one leaf slot at a time. It offers
+ * the same interface as AVLIter so code can be written against either tree.
+ ******************************************************************************/
+template<class type, int CAP>
+class BPTreeIter
+{
+public:
+
+	BPTreeIter(BPLeaf<type, CAP> *leaf = NULL, int index = 0);
+
+	int id();
+		// POST: key of the current slot
+
+	type get();
+		// POST: item of the current slot
+
+	void next();
+		// POST: moves to the next slot, crossing into the next leaf
+
+	type& operator *  ();
+	BPTreeIter<type, CAP>& operator ++ ();
+	bool  operator == (const BPTreeIter<type, CAP>& other) const;
+	bool  operator != (const BPTreeIter<type, CAP>& other) const;
+
+private:
+	BPLeaf<type, CAP> *leaf;
+	int index;
+};
+
+
+/*******************************************************************************
+ * CLASS - BPTree
+ * -----------------------------------------------------------------------------
+ * This class is a B+ tree keyed by int. It shares the insert/find/iteration
+ * interface of the AVL tree, so either may be passed as a template parameter,
+ * but stores CAP keys per node. A point lookup touches a handful of nodes
+ * rather than one per level of a binary tree, and a range scan reads keys
+ * sequentially out of the linked leaves.
+ ******************************************************************************/
+template<class type, int CAP = 64>
+class BPTree
+{
+public:
+
+	BPTree();
+	~BPTree();
+
+	bool insert(int id, type item);
+	type* find(int id);
+	void clear();
+	int  size();
+
+	// ITERATION - in key order
+	BPTreeIter<type, CAP> begin();
+	BPTreeIter<type, CAP> end();
+	BPTreeIter<type, CAP> lowerBound(int id);
+
+private:
+	typedef BPLeaf<type, CAP> Leaf;
+	typedef BPInner<CAP>      Inner;
+
+	// a tree of 2^31 keys with half full nodes is still far shallower
+	static const int MAX_DEPTH = 32;
+
+	void *root;   // POINT - to the root, a leaf when depth is 0
+	int   depth;  // CALC  - number of inner levels above the leaves
+	int   length; // CALC  - number of keys stored
+
+	// nodes are owned by the tree, so copies are not allowed
+	BPTree(const BPTree<type, CAP>&);
+	BPTree<type, CAP>& operator = (const BPTree<type, CAP>&);
+
+	// SEARCH helpers
+	static int lowerIndex(const int *keys, int count, int key);
+	static int upperIndex(const int *keys, int count, int key);
+	Leaf* findLeaf(int key);
+
+	// INSERT helpers
+	Leaf* splitLeaf(Leaf *leaf, int index, int id, type item);
+	Inner* splitInner(Inner *node, int index, int &sep, void *child);
+
+	void clearIter(void *node, int level);
+};
+
+
+/*******************************************************************************
+ * BPTreeIter
+ ******************************************************************************/
+template<class type, int CAP>
+BPTreeIter<type, CAP> :: BPTreeIter(BPLeaf<type, CAP> *leaf, int index)
+{
+	this->leaf  = leaf;
+	this->index = index;
+}
+
+template<class type, int CAP>
+int BPTreeIter<type, CAP> :: id()
+{
+	return leaf->keys[index];
+}
+
+template<class type, int CAP>
+type BPTreeIter<type, CAP> :: get()
+{
+	return leaf->items[index];
+}
+
+template<class type, int CAP>
+void BPTreeIter<type, CAP> :: next()
+{
+	if (++index == leaf->count)
+	{
+		leaf  = leaf->next;
+		index = 0;
+	}
+}
+
+template<class type, int CAP>
+type& BPTreeIter<type, CAP> :: operator * ()
+{
+	return leaf->items[index];
+}
+
+template<class type, int CAP>
+BPTreeIter<type, CAP>& BPTreeIter<type, CAP> :: operator ++ ()
+{
+	next();
+	return *this;
+}
+
+template<class type, int CAP>
+bool BPTreeIter<type, CAP> :: operator == (const BPTreeIter<type, CAP>& other) const
+{
+	return leaf == other.leaf && index == other.index;
+}
+
+template<class type, int CAP>
+bool BPTreeIter<type, CAP> :: operator != (const BPTreeIter<type, CAP>& other) const
+{
+	return !(*this == other);
+}
+
+
+/*******************************************************************************
+ * CONSTRUCTOR / DESTRUCTOR
+ ******************************************************************************/
+template<class type, int CAP>
+BPTree<type, CAP> :: BPTree()
+{
+	root   = NULL;
+	depth  = 0;
+	length = 0;
+}
+
+template<class type, int CAP>
+BPTree<type, CAP> :: ~BPTree()
+{
+	clear();
+}
+
+
+/*******************************************************************************
+ * FUNCTION - clear
+ * -----------------------------------------------------------------------------
+ * This function deletes every node in the tree. The recursion is only as deep
+ * as the tree, which stays in single digits.
+ ******************************************************************************/
+template<class type, int CAP>
+void BPTree<type, CAP> :: clear()
+{
+	if (root)
+		clearIter(root, depth);
+
+	root   = NULL;
+	depth  = 0;
+	length = 0;
+}
+
+template<class type, int CAP>
+void BPTree<type, CAP> :: clearIter(void *node, int level)
+{
+	if (level == 0)
+	{
+		delete (Leaf*)node;
+		return;
+	}
+
+	Inner *inner = (Inner*)node;
+	for (int i = 0; i <= inner->count; ++i)
+		clearIter(inner->child[i], level - 1);
+	delete inner;
+}
+
+template<class type, int CAP>
+int BPTree<type, CAP> :: size()
+{
+	return length;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - lowerIndex / upperIndex
+ * -----------------------------------------------------------------------------
+ * Binary searches over the sorted keys of a node.
+ * -----------------------------------------------------------------------------
+ * return: number of keys less than (lower) or not greater than (upper) key
+ ******************************************************************************/
+template<class type, int CAP>
+int BPTree<type, CAP> :: lowerIndex(const int *keys, int count, int key)
+{
+	int low = 0;
+
+	while (count > 0)
+	{
+		int half = count / 2;
+		if (keys[low + half] < key)
+		{
+			low   += half + 1;
+			count -= half + 1;
+		}
+		else
+			count = half;
+	}
+	return low;
+}
+
+template<class type, int CAP>
+int BPTree<type, CAP> :: upperIndex(const int *keys, int count, int key)
+{
+	int low = 0;
+
+	while (count > 0)
+	{
+		int half = count / 2;
+		if (keys[low + half] <= key)
+		{
+			low   += half + 1;
+			count -= half + 1;
+		}
+		else
+			count = half;
+	}
+	return low;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - findLeaf
+ * -----------------------------------------------------------------------------
+ * return: the leaf whose key range covers key, NULL for an empty tree
+ ******************************************************************************/
+template<class type, int CAP>
+typename BPTree<type, CAP>::Leaf* BPTree<type, CAP> :: findLeaf(int key)
+{
+	void *node = root;
+
+	for (int level = depth; node && level > 0; --level)
+	{
+		Inner *inner = (Inner*)node;
+		node = inner->child[upperIndex(inner->keys, inner->count, key)];
+	}
+	return (Leaf*)node;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - find
+ * -----------------------------------------------------------------------------
+ * return: pointer to the item stored under key, NULL if it is not contained
+ ******************************************************************************/
+template<class type, int CAP>
+type* BPTree<type, CAP> :: find(int key)
+{
+	Leaf *leaf = findLeaf(key);
+
+	if (!leaf)
+		return NULL;
+
+	int i = lowerIndex(leaf->keys, leaf->count, key);
+	return (i < leaf->count && leaf->keys[i] == key) ? &leaf->items[i] : NULL;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - begin / end / lowerBound
+ ******************************************************************************/
+template<class type, int CAP>
+BPTreeIter<type, CAP> BPTree<type, CAP> :: begin()
+{
+	void *node = root;
+
+	for (int level = depth; node && level > 0; --level)
+		node = ((Inner*)node)->child[0];
+	return BPTreeIter<type, CAP>((Leaf*)node, 0);
+}
+
+template<class type, int CAP>
+BPTreeIter<type, CAP> BPTree<type, CAP> :: end()
+{
+	return BPTreeIter<type, CAP>(NULL, 0);
+}
+
+template<class type, int CAP>
+BPTreeIter<type, CAP> BPTree<type, CAP> :: lowerBound(int key)
+{
+	Leaf *leaf = findLeaf(key);
+
+	if (!leaf)
+		return end();
+
+	int i = lowerIndex(leaf->keys, leaf->count, key);
+	if (i == leaf->count)
+		return BPTreeIter<type, CAP>(leaf->next, 0);
+	return BPTreeIter<type, CAP>(leaf, i);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - insert
+ * -----------------------------------------------------------------------------
+ * This function inserts a key into its leaf. A full leaf is split in two and
+ * the first key of the new right half is pushed into the parent, splitting
+ * inner nodes on the way up as needed. The tree only grows at the root, so
+ * every leaf stays at the same depth.
+ * -----------------------------------------------------------------------------
+ * return: bool - if the insertion was a success
+ ******************************************************************************/
+template<class type, int CAP>
+bool BPTree<type, CAP> :: insert(int id, type item)
+{
+	Inner *path[MAX_DEPTH];
+	int    slot[MAX_DEPTH];
+	void  *node = root;
+
+	if (!root)
+	{
+		Leaf *leaf = new Leaf;
+		leaf->count    = 1;
+		leaf->keys[0]  = id;
+		leaf->items[0] = item;
+		leaf->next     = NULL;
+		root   = leaf;
+		length = 1;
+		return true;
+	}
+
+	// DESCEND - remembering the way back up for splits
+	for (int level = 0; level < depth; ++level)
+	{
+		Inner *inner = (Inner*)node;
+		path[level] = inner;
+		slot[level] = upperIndex(inner->keys, inner->count, id);
+		node = inner->child[slot[level]];
+	}
+
+	Leaf *leaf = (Leaf*)node;
+	int i = lowerIndex(leaf->keys, leaf->count, id);
+	if (i < leaf->count && leaf->keys[i] == id)
+		return false;
+
+	++length;
+	if (leaf->count < CAP)
+	{
+		for (int k = leaf->count; k > i; --k)
+		{
+			leaf->keys[k]  = leaf->keys[k - 1];
+			leaf->items[k] = leaf->items[k - 1];
+		}
+		leaf->keys[i]  = id;
+		leaf->items[i] = item;
+		leaf->count++;
+		return true;
+	}
+
+	// SPLIT - push separators up until a node has room
+	void *child = splitLeaf(leaf, i, id, item);
+	int   sep   = ((Leaf*)child)->keys[0];
+
+	for (int level = depth - 1; level >= 0; --level)
+	{
+		Inner *inner = path[level];
+		int s = slot[level];
+
+		if (inner->count < CAP)
+		{
+			for (int k = inner->count; k > s; --k)
+			{
+				inner->keys[k]      = inner->keys[k - 1];
+				inner->child[k + 1] = inner->child[k];
+			}
+			inner->keys[s]      = sep;
+			inner->child[s + 1] = child;
+			inner->count++;
+			return true;
+		}
+		child = splitInner(inner, s, sep, child);
+	}
+
+	// GROW - the old root was split
+	Inner *top = new Inner;
+	top->count    = 1;
+	top->keys[0]  = sep;
+	top->child[0] = root;
+	top->child[1] = child;
+	root = top;
+	++depth;
+	return true;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - splitLeaf
+ * -----------------------------------------------------------------------------
+ * This function splits a full leaf and places the new key at index i of the
+ * combined sequence. Appending past the last leaf only moves the new key, so
+ * ascending loads leave full leaves behind instead of half empty ones.
+ * -----------------------------------------------------------------------------
+ * return: the new right leaf
+ ******************************************************************************/
+template<class type, int CAP>
+typename BPTree<type, CAP>::Leaf* BPTree<type, CAP> :: splitLeaf(Leaf *leaf, int i, int id, type item)
+{
+	Leaf *right = new Leaf;
+	int   half  = (i == CAP && !leaf->next) ? CAP : CAP / 2;
+
+	right->count = CAP - half;
+	for (int k = half; k < CAP; ++k)
+	{
+		right->keys[k - half]  = leaf->keys[k];
+		right->items[k - half] = leaf->items[k];
+	}
+	leaf->count = half;
+	right->next = leaf->next;
+	leaf->next  = right;
+
+	Leaf *target = (i <= half && half < CAP) ? leaf : right;
+	if (target == right)
+		i -= half;
+
+	for (int k = target->count; k > i; --k)
+	{
+		target->keys[k]  = target->keys[k - 1];
+		target->items[k] = target->items[k - 1];
+	}
+	target->keys[i]  = id;
+	target->items[i] = item;
+	target->count++;
+	return right;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - splitInner
+ * -----------------------------------------------------------------------------
+ * This function splits a full inner node while adding separator sep with
+ * child at slot s. The middle key moves up and is handed back through sep.
+ * -----------------------------------------------------------------------------
+ * return: the new right inner node
+ ******************************************************************************/
+template<class type, int CAP>
+typename BPTree<type, CAP>::Inner* BPTree<type, CAP> :: splitInner(Inner *node, int s, int &sep, void *child)
+{
+	int   keys[CAP + 1];
+	void *children[CAP + 2];
+
+	// MERGE - the new separator into a scratch copy of the node
+	children[0] = node->child[0];
+	for (int k = 0, j = 0; k <= CAP; ++k)
+	{
+		if (k == s)
+		{
+			keys[k]         = sep;
+			children[k + 1] = child;
+		}
+		else
+		{
+			keys[k]         = node->keys[j];
+			children[k + 1] = node->child[j + 1];
+			++j;
+		}
+	}
+
+	int mid = (CAP + 1) / 2;
+	Inner *right = new Inner;
+
+	node->count = mid;
+	for (int k = 0; k < mid; ++k)
+	{
+		node->keys[k]  = keys[k];
+		node->child[k] = children[k];
+	}
+	node->child[mid] = children[mid];
+
+	right->count = CAP - mid;
+	for (int k = mid + 1; k <= CAP; ++k)
+	{
+		right->keys[k - mid - 1]  = keys[k];
+		right->child[k - mid - 1] = children[k];
+	}
+	right->child[CAP - mid] = children[CAP + 1];
+
+	sep = keys[mid];
+	return right;
+}
+
+
+#endif /* BPTREE_H_ */
@@ -0,0 +1,320 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef BOUNDEDCACHE_H_
+#define BOUNDEDCACHE_H_
+
+#include <climits>
+#include <utility>
+
+#include "AVL.h"
+#include "AVLIter.h"
+using namespace std;
+
+
+enum EvictionPolicy
+{
+	EVICT_LRU,  // least recently used goes first
+	EVICT_LFU   // least often used goes first, least recent among equals
+};
+
+
+/*******************************************************************************
+ * STRUCT - CacheEntry / RecencyList / CacheCounters
+ * -----------------------------------------------------------------------------
+ * A CacheEntry is the item of one tree node. Its prev and next pointers thread
+ * the node onto a RecencyList, most recent use at the head, so the list costs
+ * no allocation of its own.
+ ******************************************************************************/
+template<class type>
+struct CacheEntry
+{
+	type item;
+	int  uses;                          // CALC - gets and puts, LFU only
+	Node<CacheEntry<type> > *prev;      // POINT - to the next more recent node
+	Node<CacheEntry<type> > *next;      // POINT - to the next less recent node
+};
+
+template<class type>
+struct RecencyList
+{
+	Node<CacheEntry<type> > *head;      // POINT - to the most recent node
+	Node<CacheEntry<type> > *tail;      // POINT - to the least recent node
+
+	RecencyList() : head(NULL), tail(NULL) {}
+};
+
+struct CacheCounters
+{
+	long hits;       // CALC - gets that found their key
+	long misses;     // CALC - gets that did not
+	long evictions;  // CALC - entries removed to make room
+};
+
+
+/*******************************************************************************
+ * CLASS - BoundedCache
+ * -----------------------------------------------------------------------------
+ * This class is an ordered map of at most capacity entries. Putting a new key
+ * into a full cache first evicts one entry, picked by the policy:
+ *
+ *     EVICT_LRU  the tail of one recency list of every node
+ *     EVICT_LFU  the tail of the list of nodes used least often. These lists
+ *                live in a second AVL tree keyed by use count, so the least
+ *                used list is its first node, and a use moves a node from
+ *                one list to the next
+ *
+ * Either way an eviction or a use costs O(log n). Counters of hits, misses
+ * and evictions show how well a capacity suits the workload.
+ ******************************************************************************/
+template<class type>
+class BoundedCache
+{
+public:
+
+	typedef CacheEntry<type>        Entry;
+	typedef Node<CacheEntry<type> > EntryNode;
+
+	BoundedCache(long capacity, EvictionPolicy policy = EVICT_LRU);
+
+	bool put(int id, const type& item);
+		// POST: item stored under id and counted as a use, returns true if
+		//       id is new; a full cache has evicted one other entry first
+
+	type* get(int id);
+		// POST: the item under id, counted as a use, NULL if there is none
+
+	bool erase(int id);
+		// POST: entry under id removed, false if there was none
+
+	template<class Visit>
+	void forEach(Visit visit);
+		// POST: visit(id, item) called in key order, uses not counted
+
+	long size();
+	long capacity();
+
+	static long capacityFor(long bytes, EvictionPolicy policy = EVICT_LRU);
+		// POST: entries whose nodes fit in bytes, allocator overhead and
+		//       LFU use count lists included
+
+	CacheCounters counters();
+	void resetCounters();
+
+private:
+
+	// the cache owns its trees, so copies are not allowed
+	BoundedCache(const BoundedCache<type>&);
+	BoundedCache<type>& operator = (const BoundedCache<type>&);
+
+	AVL<Entry>               entries;
+	AVL<RecencyList<type> >  byUses;   // LFU - one list per use count
+	RecencyList<type>        recency;  // LRU - every node
+	EvictionPolicy           policy;
+	long                     limit;    // CALC - most entries held
+	long                     count;    // CALC - entries held
+	CacheCounters            stats;
+
+	RecencyList<type>& listOf(EntryNode *node);
+	void link(EntryNode *node);
+	void unlink(EntryNode *node);
+	void touch(EntryNode *node);
+	void evict();
+};
+
+
+template<class type>
+BoundedCache<type> :: BoundedCache(long capacity, EvictionPolicy policy)
+{
+	this->policy = policy;
+	limit = capacity < 1 ? 1 : capacity;
+	count = 0;
+	resetCounters();
+}
+
+template<class type>
+long BoundedCache<type> :: size()
+{
+	return count;
+}
+
+template<class type>
+long BoundedCache<type> :: capacity()
+{
+	return limit;
+}
+
+/*******************************************************************************
+ * FUNCTION - capacityFor
+ * -----------------------------------------------------------------------------
+ * Node bytes are those stats() reports. Under LFU every entry may hold a use
+ * count of its own, so each is charged one node of byUses as well.
+ ******************************************************************************/
+template<class type>
+long BoundedCache<type> :: capacityFor(long bytes, EvictionPolicy policy)
+{
+	long perEntry = AVL<Entry>::nodeBytes();
+
+	if (policy == EVICT_LFU)
+		perEntry += AVL<RecencyList<type> >::nodeBytes();
+	return bytes / perEntry;
+}
+
+template<class type>
+CacheCounters BoundedCache<type> :: counters()
+{
+	return stats;
+}
+
+template<class type>
+void BoundedCache<type> :: resetCounters()
+{
+	stats.hits      = 0;
+	stats.misses    = 0;
+	stats.evictions = 0;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - put
+ * -----------------------------------------------------------------------------
+ * One descent finds or adds the node. A new node is not on any list yet, so
+ * the eviction that makes room for it can never pick it.
+ ******************************************************************************/
+template<class type>
+bool BoundedCache<type> :: put(int id, const type& item)
+{
+	pair<EntryNode*, bool> at = entries.findOrInsert(id);
+	EntryNode *node = at.first;
+
+	node->item.item = item;
+	if (!at.second)
+	{
+		touch(node);
+		return false;
+	}
+
+	if (count == limit)
+		evict();
+	++count;
+
+	node->item.uses = 1;
+	link(node);
+	return true;
+}
+
+template<class type>
+type* BoundedCache<type> :: get(int id)
+{
+	EntryNode *node = entries.findNode(id);
+
+	if (!node)
+	{
+		++stats.misses;
+		return NULL;
+	}
+
+	++stats.hits;
+	touch(node);
+	return &node->item.item;
+}
+
+template<class type>
+bool BoundedCache<type> :: erase(int id)
+{
+	EntryNode *node = entries.findNode(id);
+
+	if (!node)
+		return false;
+
+	unlink(node);
+	entries.remove(id);
+	--count;
+	return true;
+}
+
+template<class type>
+template<class Visit>
+void BoundedCache<type> :: forEach(Visit visit)
+{
+	for (AVLIter<Entry> it = entries.begin(); it != entries.end(); ++it)
+		visit(it.id(), (*it).item);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - listOf / link / unlink
+ * -----------------------------------------------------------------------------
+ * link puts a node at the head of its list, adding the list for its use count
+ * if it has none. unlink takes it out again, and drops a use count list that
+ * it leaves empty.
+ ******************************************************************************/
+template<class type>
+RecencyList<type>& BoundedCache<type> :: listOf(EntryNode *node)
+{
+	if (policy == EVICT_LRU)
+		return recency;
+	return byUses.findOrInsert(node->item.uses).first->item;
+}
+
+template<class type>
+void BoundedCache<type> :: link(EntryNode *node)
+{
+	RecencyList<type> &list = listOf(node);
+
+	node->item.prev = NULL;
+	node->item.next = list.head;
+	if (list.head)
+		list.head->item.prev = node;
+	else
+		list.tail = node;
+	list.head = node;
+}
+
+template<class type>
+void BoundedCache<type> :: unlink(EntryNode *node)
+{
+	RecencyList<type> &list = listOf(node);
+
+	if (node->item.prev)
+		node->item.prev->item.next = node->item.next;
+	else
+		list.head = node->item.next;
+
+	if (node->item.next)
+		node->item.next->item.prev = node->item.prev;
+	else
+		list.tail = node->item.prev;
+
+	if (policy == EVICT_LFU && !list.head)
+		byUses.remove(node->item.uses);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - touch / evict
+ ******************************************************************************/
+template<class type>
+void BoundedCache<type> :: touch(EntryNode *node)
+{
+	unlink(node);
+	if (policy == EVICT_LFU && node->item.uses < INT_MAX)
+		++node->item.uses;
+	link(node);
+}
+
+template<class type>
+void BoundedCache<type> :: evict()
+{
+	EntryNode *victim = policy == EVICT_LRU ? recency.tail
+	                                        : (*byUses.begin()).tail;
+
+	unlink(victim);
+	entries.remove(victim->id);
+	--count;
+	++stats.evictions;
+}
+
+
+#endif /* BOUNDEDCACHE_H_ */
@@ -0,0 +1,322 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef CONCURRENTQUEUE_H_
+#define CONCURRENTQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include "List.h"
+using namespace std;
+
+
+/*******************************************************************************
+ * CLASS MPSCQueue
+ * -----------------------------------------------------------------------------
+ * This class is an unbounded queue that any number of threads may push onto
+ * while one thread pops. It is Dmitry Vyukov's intrusive MPSC queue threaded
+ * through the next pointers of Link structs. A push is one atomic exchange and
+ * one store, so producers never wait on each other or on the consumer.
+ *
+ * A producer swaps its link in as the new head and only then points the old
+ * head at it. A consumer that arrives between those two steps sees the queue
+ * end early, so try_pop can miss a link whose push has not finished yet. It
+ * is returned by a later call.
+ *
+ * Links come from new rather than the LinkPool, whose shared slabs sit
+ * behind a lock that a producer would take each time its cache runs dry.
+ ******************************************************************************/
+template <class type>
+class MPSCQueue
+{
+public:
+
+	MPSCQueue();
+	~MPSCQueue();
+
+	void push(const type& item);
+		// POST: item is at the back of the queue, safe from any thread
+
+	bool try_pop(type& item);
+		// POST: front item copied to item, false if none is ready
+		//       consumer thread only
+
+	int pop_batch(type *batch, int max);
+		// POST: up to max ready items copied to batch, returns how many
+		//       consumer thread only
+
+	bool isEmpty();
+		// POST: true if no push has been made visible yet, consumer only
+
+private:
+
+	// the queue owns its links, so copies are not allowed
+	MPSCQueue(const MPSCQueue<type>&);
+	MPSCQueue<type>& operator = (const MPSCQueue<type>&);
+
+	Link<type> *head;   // POINT - to the link pushed last, producers swap it
+	char pad[64 - sizeof(Link<type>*)];
+	Link<type> *tail;   // POINT - to the next link to pop, consumer only
+	Link<type>  stub;   // CALC  - placeholder that keeps the queue non-empty
+
+	void enqueue(Link<type> *link);
+	Link<type>* dequeue();
+};
+
+
+template <class type>
+MPSCQueue<type> :: MPSCQueue()
+{
+	stub.next = NULL;
+	stub.prev = NULL;
+	head = &stub;
+	tail = &stub;
+}
+
+template <class type>
+MPSCQueue<type> :: ~MPSCQueue()
+{
+	Link<type> *link;
+
+	while ((link = dequeue()) != NULL)
+		delete link;
+}
+
+
+/*******************************************************************************
+ * METHOD enqueue
+ * -----------------------------------------------------------------------------
+ * The exchange publishes link as the head; the release store then hands the
+ * link's item to whichever thread follows the old head's next pointer.
+ ******************************************************************************/
+template <class type>
+void MPSCQueue<type> :: enqueue(Link<type> *link)
+{
+	__atomic_store_n(&link->next, (Link<type>*)NULL, __ATOMIC_RELAXED);
+	Link<type> *prev = __atomic_exchange_n(&head, link, __ATOMIC_ACQ_REL);
+	__atomic_store_n(&prev->next, link, __ATOMIC_RELEASE);
+}
+
+
+/*******************************************************************************
+ * METHOD dequeue
+ * -----------------------------------------------------------------------------
+ * This method unlinks the front link, skipping over the stub. When the only
+ * link left is the tail the stub is pushed behind it first, so the last real
+ * link can be handed out without the queue ever running empty.
+ * -----------------------------------------------------------------------------
+ * return: the front link, NULL if none is ready
+ ******************************************************************************/
+template <class type>
+Link<type>* MPSCQueue<type> :: dequeue()
+{
+	Link<type> *front = tail;
+	Link<type> *next  = __atomic_load_n(&front->next, __ATOMIC_ACQUIRE);
+
+	// SKIP - the stub holds no item
+	if (front == &stub)
+	{
+		if (next == NULL)
+			return NULL;
+		tail  = next;
+		front = next;
+		next  = __atomic_load_n(&front->next, __ATOMIC_ACQUIRE);
+	}
+
+	if (next)
+	{
+		tail = next;
+		return front;
+	}
+
+	// a producer has swapped in a newer head but not linked it yet
+	if (front != __atomic_load_n(&head, __ATOMIC_ACQUIRE))
+		return NULL;
+
+	enqueue(&stub);
+	next = __atomic_load_n(&front->next, __ATOMIC_ACQUIRE);
+	if (next)
+	{
+		tail = next;
+		return front;
+	}
+	return NULL;
+}
+
+template <class type>
+void MPSCQueue<type> :: push(const type& item)
+{
+	Link<type> *link = new Link<type>;
+	link->item = item;
+	link->prev = NULL;
+	enqueue(link);
+}
+
+template <class type>
+bool MPSCQueue<type> :: try_pop(type& item)
+{
+	Link<type> *link = dequeue();
+
+	if (link == NULL)
+		return false;
+
+	item = link->item;
+	delete link;
+	return true;
+}
+
+template <class type>
+int MPSCQueue<type> :: pop_batch(type *batch, int max)
+{
+	int n = 0;
+
+	while (n < max && try_pop(batch[n]))
+		++n;
+	return n;
+}
+
+template <class type>
+bool MPSCQueue<type> :: isEmpty()
+{
+	return tail == &stub && __atomic_load_n(&stub.next, __ATOMIC_ACQUIRE) == NULL;
+}
+
+
+/*******************************************************************************
+ * CLASS SPSCRing
+ * -----------------------------------------------------------------------------
+ * This class is a bounded queue between exactly one producer thread and one
+ * consumer thread. Items sit in a power of two array and each side owns one
+ * index, so neither side ever writes what the other writes. Each side also
+ * keeps a private copy of the other's index and only reloads it when the
+ * copy says the ring is full or empty, which keeps the shared cache lines
+ * quiet while the ring is neither.
+ ******************************************************************************/
+template <class type>
+class SPSCRing
+{
+public:
+
+	SPSCRing(int capacity);
+		// POST: ring holds at least capacity items
+	~SPSCRing();
+
+	bool push(const type& item);
+		// POST: item is at the back of the ring, false if the ring is full
+		//       producer thread only
+
+	bool try_pop(type& item);
+		// POST: front item copied to item, false if the ring is empty
+		//       consumer thread only
+
+	int pop_batch(type *batch, int max);
+		// POST: up to max items copied to batch, returns how many
+		//       consumer thread only
+
+	int capacity();
+
+private:
+
+	// the ring owns its slots, so copies are not allowed
+	SPSCRing(const SPSCRing<type>&);
+	SPSCRing<type>& operator = (const SPSCRing<type>&);
+
+	static const int LINE = 64;
+
+	// SHARED - read only once built
+	type   *slots;
+	size_t  mask;
+	char padRead[LINE - sizeof(type*) - sizeof(size_t)];
+
+	// PRODUCER - one cache line
+	atomic<size_t> back;      // CALC - items pushed so far
+	size_t         frontSeen; // CALC - producer's copy of front
+	char padBack[LINE - sizeof(atomic<size_t>) - sizeof(size_t)];
+
+	// CONSUMER - one cache line
+	atomic<size_t> front;     // CALC - items popped so far
+	size_t         backSeen;  // CALC - consumer's copy of back
+	char padFront[LINE - sizeof(atomic<size_t>) - sizeof(size_t)];
+};
+
+
+template <class type>
+SPSCRing<type> :: SPSCRing(int capacity)
+{
+	size_t size = 1;
+
+	while (size < (size_t)capacity)
+		size <<= 1;
+
+	slots = new type[size];
+	mask  = size - 1;
+	back.store(0, memory_order_relaxed);
+	front.store(0, memory_order_relaxed);
+	frontSeen = 0;
+	backSeen  = 0;
+}
+
+template <class type>
+SPSCRing<type> :: ~SPSCRing()
+{
+	delete [] slots;
+}
+
+template <class type>
+bool SPSCRing<type> :: push(const type& item)
+{
+	size_t at = back.load(memory_order_relaxed);
+
+	if (at - frontSeen > mask)
+	{
+		frontSeen = front.load(memory_order_acquire);
+		if (at - frontSeen > mask)
+			return false;
+	}
+
+	slots[at & mask] = item;
+	back.store(at + 1, memory_order_release);
+	return true;
+}
+
+template <class type>
+bool SPSCRing<type> :: try_pop(type& item)
+{
+	return pop_batch(&item, 1) == 1;
+}
+
+
+/*******************************************************************************
+ * METHOD pop_batch
+ * -----------------------------------------------------------------------------
+ * The whole batch is claimed with one store to front, so a full drain costs
+ * the producer a single cache line transfer rather than one per item.
+ ******************************************************************************/
+template <class type>
+int SPSCRing<type> :: pop_batch(type *batch, int max)
+{
+	size_t at = front.load(memory_order_relaxed);
+
+	if (backSeen - at < (size_t)max)
+		backSeen = back.load(memory_order_acquire);
+
+	size_t ready = backSeen - at;
+	int    n     = ready < (size_t)max ? (int)ready : max;
+
+	for (int i = 0; i < n; ++i)
+		batch[i] = slots[(at + i) & mask];
+
+	if (n > 0)
+		front.store(at + n, memory_order_release);
+	return n;
+}
+
+template <class type>
+int SPSCRing<type> :: capacity()
+{
+	return (int)(mask + 1);
+}
+
+
+#endif /* CONCURRENTQUEUE_H_ */
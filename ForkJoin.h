@@ -0,0 +1,373 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef FORKJOIN_H_
+#define FORKJOIN_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+
+/*******************************************************************************
+ * CLASS - ForkJoin
+ * -----------------------------------------------------------------------------
+ * This class is a work-stealing thread pool for divide and conquer. invoke(a,
+ * b) offers b to the pool, runs a on the calling thread and then runs b too
+ * unless another thread took it first. Each thread pushes and pops offered
+ * tasks at the back of its own queue, where they are still warm in its cache,
+ * and idle threads steal from the front of other queues, where the biggest,
+ * oldest tasks sit. A thread waiting for a stolen task runs other tasks
+ * meanwhile, so nested invokes never leave a thread blocked.
+ *
+ * A pool of n threads starts n - 1 workers; the thread that calls invoke is
+ * the n-th. A pool of one thread runs everything in order on the caller.
+ ******************************************************************************/
+class ForkJoin
+{
+public:
+
+	ForkJoin(int threads = 0);
+		// POST: pool of threads threads, one per core if 0
+	~ForkJoin();
+
+	template<class A, class B>
+	void invoke(const A& a, const B& b);
+		// POST: a() and b() have both returned, possibly run in parallel
+
+	int threads();
+		// POST: threads that run tasks, the calling thread included
+
+	static ForkJoin& shared();
+		// POST: the pool with one thread per core, started on first use
+
+private:
+
+	// the pool owns its threads, so copies are not allowed
+	ForkJoin(const ForkJoin&);
+	ForkJoin& operator = (const ForkJoin&);
+
+	struct Task
+	{
+		function<void()> run;
+		atomic<bool>     done;
+	};
+
+	struct Queue
+	{
+		mutex        lock;
+		deque<Task*> tasks;
+		char         pad[64];  // keeps neighbouring queues off one line
+	};
+
+	long              id;        // CALC - tells pools apart in thread slots
+	int               count;     // CALC - threads including the caller
+	vector<Queue*>    queues;    // one per worker, the last for callers
+	vector<thread>    workers;
+	atomic<bool>      stopping;
+	atomic<int>       sleepers;  // CALC - workers waiting for tasks
+	mutex             sleepLock;
+	condition_variable wake;
+
+	struct Slot
+	{
+		long pool;   // id of the pool the thread works for, 0 if none
+		int  index;  // its queue in that pool
+	};
+
+	static Slot& slot();
+	int  self();
+	bool runOne(int self);
+	bool take(int self, Task *task);
+	void work(int index);
+};
+
+
+inline ForkJoin :: ForkJoin(int threads)
+{
+	static atomic<long> pools(0);
+
+	id    = ++pools;
+	count = threads > 0 ? threads : max(1, (int)thread::hardware_concurrency());
+	stopping.store(false);
+	sleepers.store(0);
+
+	for (int i = 0; i < count; ++i)
+		queues.push_back(new Queue);
+	for (int i = 0; i < count - 1; ++i)
+		workers.push_back(thread(&ForkJoin::work, this, i));
+}
+
+inline ForkJoin :: ~ForkJoin()
+{
+	{
+		lock_guard<mutex> guard(sleepLock);
+		stopping.store(true);
+	}
+	wake.notify_all();
+
+	for (size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();
+	for (size_t i = 0; i < queues.size(); ++i)
+		delete queues[i];
+}
+
+inline int ForkJoin :: threads()
+{
+	return count;
+}
+
+inline ForkJoin& ForkJoin :: shared()
+{
+	static ForkJoin pool;
+	return pool;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - self
+ * -----------------------------------------------------------------------------
+ * return: the calling thread's queue; threads outside the pool share the last
+ ******************************************************************************/
+inline ForkJoin::Slot& ForkJoin :: slot()
+{
+	static thread_local Slot mine = { 0, 0 };
+	return mine;
+}
+
+inline int ForkJoin :: self()
+{
+	Slot &mine = slot();
+	return mine.pool == id ? mine.index : count - 1;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - invoke
+ ******************************************************************************/
+template<class A, class B>
+void ForkJoin :: invoke(const A& a, const B& b)
+{
+	if (count == 1)
+	{
+		a();
+		b();
+		return;
+	}
+
+	int  me = self();
+	Task task;
+	task.run = b;
+	task.done.store(false, memory_order_relaxed);
+
+	{
+		lock_guard<mutex> guard(queues[me]->lock);
+		queues[me]->tasks.push_back(&task);
+	}
+	if (sleepers.load(memory_order_relaxed) > 0)
+		wake.notify_one();
+
+	a();
+
+	// JOIN - run b here if nobody stole it, else help until it is done
+	if (take(me, &task))
+		b();
+	else
+		while (!task.done.load(memory_order_acquire))
+			if (!runOne(me))
+				this_thread::yield();
+}
+
+
+/*******************************************************************************
+ * FUNCTION - take
+ * -----------------------------------------------------------------------------
+ * Takes task back off the thread's own queue. Tasks offered after it have all
+ * been joined by now, so if it is still queued it is at or near the back.
+ * -----------------------------------------------------------------------------
+ * return: true if task was still queued
+ ******************************************************************************/
+inline bool ForkJoin :: take(int self, Task *task)
+{
+	Queue &queue = *queues[self];
+	lock_guard<mutex> guard(queue.lock);
+
+	for (deque<Task*>::reverse_iterator it = queue.tasks.rbegin();
+	     it != queue.tasks.rend(); ++it)
+	{
+		if (*it == task)
+		{
+			queue.tasks.erase(next(it).base());
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - runOne
+ * -----------------------------------------------------------------------------
+ * Runs the newest task of the thread's own queue, or failing that steals the
+ * oldest task of another queue.
+ * -----------------------------------------------------------------------------
+ * return: true if a task was run
+ ******************************************************************************/
+inline bool ForkJoin :: runOne(int self)
+{
+	Task *task = NULL;
+
+	for (int i = 0; i < count && !task; ++i)
+	{
+		Queue &queue = *queues[(self + i) % count];
+		lock_guard<mutex> guard(queue.lock);
+
+		if (!queue.tasks.empty())
+		{
+			if (i == 0)
+			{
+				task = queue.tasks.back();
+				queue.tasks.pop_back();
+			}
+			else
+			{
+				task = queue.tasks.front();
+				queue.tasks.pop_front();
+			}
+		}
+	}
+
+	if (!task)
+		return false;
+
+	task->run();
+	task->done.store(true, memory_order_release);
+	return true;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - work
+ * -----------------------------------------------------------------------------
+ * A worker's loop. After a stretch of finding nothing to run it sleeps until
+ * a task is offered, waking now and then in case it missed the signal.
+ ******************************************************************************/
+inline void ForkJoin :: work(int index)
+{
+	int idle = 0;
+
+	slot().pool  = id;
+	slot().index = index;
+
+	while (!stopping.load(memory_order_relaxed))
+	{
+		if (runOne(index))
+		{
+			idle = 0;
+			continue;
+		}
+		if (++idle < 64)
+		{
+			this_thread::yield();
+			continue;
+		}
+
+		unique_lock<mutex> guard(sleepLock);
+		sleepers.fetch_add(1);
+		if (!stopping.load())
+			wake.wait_for(guard, chrono::milliseconds(1));
+		sleepers.fetch_sub(1);
+		idle = 0;
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - parallelMerge
+ * -----------------------------------------------------------------------------
+ * Stable merge of [a, aEnd) and [b, bEnd) into out. The longer run is split
+ * at its middle and the other at the matching bound, which leaves two
+ * independent merges that run in parallel. Ties go to the first run.
+ ******************************************************************************/
+template<class T, class Less>
+void parallelMerge(T *a, T *aEnd, T *b, T *bEnd, T *out, Less less, ForkJoin &pool)
+{
+	const long GRAIN = 1 << 14;
+
+	if ((aEnd - a) + (bEnd - b) <= GRAIN)
+	{
+		merge(a, aEnd, b, bEnd, out, less);
+		return;
+	}
+
+	T *aMid, *bMid;
+	if (aEnd - a >= bEnd - b)
+	{
+		aMid = a + (aEnd - a) / 2;
+		bMid = lower_bound(b, bEnd, *aMid, less);
+	}
+	else
+	{
+		bMid = b + (bEnd - b) / 2;
+		aMid = upper_bound(a, aEnd, *bMid, less);
+	}
+
+	T *outMid = out + (aMid - a) + (bMid - b);
+	pool.invoke([&]() { parallelMerge(a, aMid, b, bMid, out, less, pool); },
+	            [&]() { parallelMerge(aMid, aEnd, bMid, bEnd, outMid, less, pool); });
+}
+
+
+/*******************************************************************************
+ * FUNCTION - parallelSort
+ * -----------------------------------------------------------------------------
+ * Stable merge sort of [first, first + n) that sorts both halves in parallel
+ * and merges them in parallel. The halves are sorted into buffer and merged
+ * back, or the other way round, so each level moves every item once.
+ * buffer must hold n items.
+ ******************************************************************************/
+template<class T, class Less>
+void parallelSort(T *first, long n, T *buffer, bool intoBuffer, Less less, ForkJoin &pool)
+{
+	const long GRAIN = 1 << 14;
+
+	if (n <= GRAIN)
+	{
+		stable_sort(first, first + n, less);
+		if (intoBuffer)
+			copy(first, first + n, buffer);
+		return;
+	}
+
+	long half = n / 2;
+	pool.invoke([&]() { parallelSort(first, half, buffer, !intoBuffer, less, pool); },
+	            [&]() { parallelSort(first + half, n - half, buffer + half, !intoBuffer, less, pool); });
+
+	T *from = intoBuffer ? first : buffer;
+	T *to   = intoBuffer ? buffer : first;
+	parallelMerge(from, from + half, from + half, from + n, to, less, pool);
+}
+
+template<class T, class Less>
+void parallelSort(T *first, long n, Less less, ForkJoin &pool = ForkJoin::shared())
+{
+	if (pool.threads() == 1 || n <= (1 << 14))
+	{
+		stable_sort(first, first + n, less);
+		return;
+	}
+
+	vector<T> buffer(n);
+	parallelSort(first, n, &buffer[0], false, less, pool);
+}
+
+
+#endif /* FORKJOIN_H_ */
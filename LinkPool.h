@@ -0,0 +1,293 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef LINKPOOL_H_
+#define LINKPOOL_H_
+
+#include <map>
+#include <mutex>
+#include <stdint.h>
+using namespace std;
+
+template <class type>
+struct Link;
+
+
+/*******************************************************************************
+ * CLASS LinkPool
+ * -----------------------------------------------------------------------------
+ * This class hands out Link structs for every List of one item type, on every
+ * thread. Links are carved out of slabs of SLAB_LINKS at a time, and a
+ * released link goes back to the free list of the slab it came from, so a
+ * List filled on one thread and drained on another reuses its links like any
+ * other.
+ *
+ * The slabs are shared under one lock. So that a push or pop does not take
+ * it, each thread keeps a small cache of links that it fills and empties
+ * CACHE_LINKS at a time, and hands back when the thread exits.
+ *
+ * A slab whose links have all come back is freed, except for up to
+ * SPARE_SLABS empty slabs kept for the next burst of pushes. The slabs held
+ * therefore follow the links in use rather than the most ever used.
+ ******************************************************************************/
+template <class type>
+class LinkPool
+{
+public:
+
+	static Link<type>* acquire();
+		// POST: an unlinked Link from the calling thread's cache
+
+	static void release(Link<type> *link);
+		// POST: link's item is reset and link is back in the pool
+
+	static long reservedBytes();
+		// POST: bytes held in slabs for every thread
+
+private:
+
+	static const int SLAB_LINKS  = 256;
+	static const int CACHE_LINKS = 128;
+	static const int SPARE_SLABS = 4;
+
+	struct Slab
+	{
+		Slab       *prev;             // POINT - to the previous slab with free links
+		Slab       *next;             // POINT - to the next slab with free links
+		Link<type> *free;             // POINT - to the slab's first free link
+		int         used;             // CALC  - links out of the slab, cached ones included
+		Link<type>  links[SLAB_LINKS];
+	};
+
+	struct Shared
+	{
+		mutex                   lock;
+		map<uintptr_t, Slab*>   slabs;  // CALC  - every slab, by address
+		Slab                   *open;   // POINT - to the slabs with free links
+		int                     empty;  // CALC  - slabs with no link out
+
+		Shared() : open(NULL), empty(0) {}
+	};
+
+	// plain data, so a thread reaches its cache without an init guard
+	struct Cache
+	{
+		Link<type> *free;  // POINT - to the thread's first cached link
+		int         count; // CALC  - links in the cache
+	};
+
+	// hands the thread's cache back when the thread exits
+	struct CacheOwner
+	{
+		~CacheOwner() { LinkPool<type>::flush(cache(), cache().count); }
+	};
+
+	static Shared& shared();
+	static Cache& cache();
+	static void refill(Cache& cache);
+	static void flush(Cache& cache, int n);
+	static Slab* slabOf(Shared& pool, Link<type> *link);
+	static void openSlab(Shared& pool, Slab *slab);
+	static void closeSlab(Shared& pool, Slab *slab);
+};
+
+
+template <class type>
+typename LinkPool<type>::Shared& LinkPool<type> :: shared()
+{
+	// never destroyed, so a List that outlives main can still hand links back
+	static Shared *pool = new Shared;
+	return *pool;
+}
+
+template <class type>
+typename LinkPool<type>::Cache& LinkPool<type> :: cache()
+{
+	static thread_local Cache local = { NULL, 0 };
+	return local;
+}
+
+template <class type>
+long LinkPool<type> :: reservedBytes()
+{
+	Shared &pool = shared();
+	lock_guard<mutex> guard(pool.lock);
+
+	return (long)pool.slabs.size() * sizeof(Slab);
+}
+
+
+template <class type>
+Link<type>* LinkPool<type> :: acquire()
+{
+	Cache &local = cache();
+
+	if (local.free == NULL)
+		refill(local);
+
+	Link<type> *link = local.free;
+	local.free = link->next;
+	--local.count;
+	link->next = NULL;
+	link->prev = NULL;
+	return link;
+}
+
+template <class type>
+void LinkPool<type> :: release(Link<type> *link)
+{
+	Cache &local = cache();
+
+	// RESET - so a pooled link holds on to nothing the item owned
+	link->item = type();
+	link->prev = NULL;
+	link->next = local.free;
+	local.free = link;
+
+	if (++local.count == 2 * CACHE_LINKS)
+		flush(local, CACHE_LINKS);
+}
+
+
+/*******************************************************************************
+ * METHOD refill
+ * -----------------------------------------------------------------------------
+ * This method moves CACHE_LINKS links from the open slabs into the calling
+ * thread's cache, reserving a new slab whenever no slab has a free link.
+ ******************************************************************************/
+template <class type>
+void LinkPool<type> :: refill(Cache& local)
+{
+	static thread_local CacheOwner owner;
+	(void)owner;
+
+	Shared &pool = shared();
+	lock_guard<mutex> guard(pool.lock);
+
+	while (local.count < CACHE_LINKS)
+	{
+		Slab *slab = pool.open;
+
+		if (slab == NULL)
+		{
+			slab = new Slab;
+			slab->used = 0;
+			slab->free = NULL;
+			for (int i = SLAB_LINKS - 1; i >= 0; --i)
+			{
+				slab->links[i].next = slab->free;
+				slab->free = &slab->links[i];
+			}
+			pool.slabs[(uintptr_t)slab] = slab;
+			openSlab(pool, slab);
+			++pool.empty;
+		}
+
+		if (slab->used == 0)
+			--pool.empty;
+
+		// MOVE - every free link of the slab the cache still has room for
+		while (slab->free != NULL && local.count < CACHE_LINKS)
+		{
+			Link<type> *link = slab->free;
+			slab->free = link->next;
+			link->next = local.free;
+			local.free = link;
+			++local.count;
+			++slab->used;
+		}
+
+		if (slab->free == NULL)
+			closeSlab(pool, slab);
+	}
+}
+
+
+/*******************************************************************************
+ * METHOD flush
+ * -----------------------------------------------------------------------------
+ * This method hands n links from the calling thread's cache back to their
+ * slabs. A slab left with no link out is freed once SPARE_SLABS empty slabs
+ * are already kept.
+ ******************************************************************************/
+template <class type>
+void LinkPool<type> :: flush(Cache& local, int n)
+{
+	if (n == 0)
+		return;
+
+	Shared &pool = shared();
+	lock_guard<mutex> guard(pool.lock);
+
+	Slab *slab = NULL;
+
+	for (int i = 0; i < n; ++i)
+	{
+		Link<type> *link = local.free;
+
+		// LOOKUP - links freed together mostly share a slab
+		if (!slab || link < slab->links || link >= slab->links + SLAB_LINKS)
+			slab = slabOf(pool, link);
+
+		local.free = link->next;
+		--local.count;
+
+		if (slab->free == NULL)
+			openSlab(pool, slab);
+		link->next = slab->free;
+		slab->free = link;
+
+		if (--slab->used > 0)
+			continue;
+
+		if (pool.empty < SPARE_SLABS)
+			++pool.empty;
+		else
+		{
+			closeSlab(pool, slab);
+			pool.slabs.erase((uintptr_t)slab);
+			delete slab;
+			slab = NULL;
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * METHOD slabOf / openSlab / closeSlab
+ * -----------------------------------------------------------------------------
+ * slabOf finds the slab holding a link: the one at the highest address not
+ * above it. openSlab and closeSlab add a slab to or take it off the chain of
+ * slabs with free links.
+ ******************************************************************************/
+template <class type>
+typename LinkPool<type>::Slab* LinkPool<type> :: slabOf(Shared& pool, Link<type> *link)
+{
+	typename map<uintptr_t, Slab*>::iterator at = pool.slabs.upper_bound((uintptr_t)link);
+	return (--at)->second;
+}
+
+template <class type>
+void LinkPool<type> :: openSlab(Shared& pool, Slab *slab)
+{
+	slab->prev = NULL;
+	slab->next = pool.open;
+	if (pool.open)
+		pool.open->prev = slab;
+	pool.open = slab;
+}
+
+template <class type>
+void LinkPool<type> :: closeSlab(Shared& pool, Slab *slab)
+{
+	if (slab->prev)
+		slab->prev->next = slab->next;
+	else
+		pool.open = slab->next;
+	if (slab->next)
+		slab->next->prev = slab->prev;
+}
+
+
+#endif /* LINKPOOL_H_ */
@@ -6,6 +6,8 @@
 #define LIST_H_
 
 #include <iostream>
+#include <cstdlib>
+#include "LinkPool.h"
 using namespace std;
 
 /*******************************************************************************
@@ -23,6 +25,24 @@ struct Link
 	Link<type> *prev; // POINT - to previous link
 };
 
+/*******************************************************************************
+ * LIST_CONTIGUOUS
+ * -----------------------------------------------------------------------------
+ * Compile-time switch for the storage behind List. When it is defined, the
+ * linked list below is compiled as LinkedList and List<type> names the
+ * contiguous Sequence<type> instead, which keeps the same interface.
+ ******************************************************************************/
+#ifdef LIST_CONTIGUOUS
+#include "Sequence.h"
+#define List LinkedList
+#endif
+
+template<class type>
+class ListIter;
+
+template<class type>
+class ListConstIter;
+
 /*******************************************************************************
  * CLASS List
  * -----------------------------------------------------------------------------
@@ -35,6 +55,9 @@ class List
 {
 public:
 
+	typedef ListIter<type>      iterator;
+	typedef ListConstIter<type> const_iterator;
+
 	List();
 		// Default Constructor
 
@@ -82,33 +105,57 @@ public:
 
 	type peek();
 
+	void splice(ListIter<type> pos, List<type>& other);
+		// moves all of other's links in before pos in O(1)
+
+	void splice(ListIter<type> pos, List<type>& other,
+	            ListIter<type> first, ListIter<type> last, int count = -1);
+		// moves other's links from first up to last in before pos
+
+	void merge(List<type>& other);
+		// merges sorted other into this sorted list in O(n)
+
+	void sort();
+		// stable merge sort of the links in O(n log n)
+
+	void reverse();
+		// reverses the order of the links in O(n)
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+		// iterators over the links, end is one past the tail
+
 private:
 
-	int length;       // length of the list
-	Link<type> *head; // head of the list
-	Link<type> *tail; // tail of the list
+	friend class ListIter<type>;
+	friend class ListConstIter<type>;
 
-	void addIter(int i, int n, Link<type> *element, Link<type> *node);
-		// helper method for add middle
+	int length;        // length of the list
+	Link<type> *head;  // head of the list
+	Link<type> *tail;  // tail of the list
 
-	void removeIter(int i, int n, Link<type> *node);
-		// helper method for remove
+	int cacheIndex;    // index of the last accessed link, -1 if unknown
+	Link<type> *cache; // the last accessed link
 
-	type getNodeIter(int i, int n, Link<type> *node);
-		// helper method for getNode
+	Link<type>* linkAt(int index);
+		// walks to a valid index from the closest known link
 
-	Link<type>* getIter(int i, int n, Link<type> *node);
-		// helper method for get
+	void insertBefore(Link<type> *node, Link<type> *element);
+		// links element in before node, or at the tail if node is NULL
 
-	bool containsIter(int i, type item, bool contains, Link<type> *node);
-		// helper method for contains
+	void unlink(Link<type> *node);
+		// takes node off the list without deleting it
 
-	void printIter(Link<type> *node);
-		// helper method for print
+	void spliceChain(Link<type> *node, Link<type> *first, Link<type> *last, int count);
+		// links the chain first..last in before node
 
-	int index(type item);
+	void relink();
+		// rebuilds prev pointers and tail from the next chain
 
-	int indexIter(Link<type> *node, int index);
+	static Link<type>* mergeChains(Link<type> *a, Link<type> *b);
+		// merges two sorted NULL terminated next chains
 };
 
 
@@ -123,6 +170,8 @@ List <type> :: List()
 	length = 0;
 	head = NULL;
 	tail = NULL;
+	cacheIndex = -1;
+	cache = NULL;
 }
 
 
@@ -176,7 +225,7 @@ void List<type> :: add(const type& newElement)
 	Link<type> *node;
 
 	// INITIALIZE
-	node = new Link<type>;
+	node = LinkPool<type>::acquire();
 
 	// IF - fails if there is no available memory
 	if(node != NULL)
@@ -223,7 +272,7 @@ void List<type> :: add(int index,const type& newElement)
 	Link<type> *element; // ITERATOR - traverses the list
 
 	// INITIALIZE
-	element = new Link<type>;
+	element = LinkPool<type>::acquire();
 
 	// IF - fails if there is no available memory
 	if(element != NULL)
@@ -234,41 +283,12 @@ void List<type> :: add(int index,const type& newElement)
 		// IF - the index is within the bounds of the array, add it
 		if(index <= length && index >= 0)
 		{
-			if(index == 0)
-			{
-				element->prev = NULL;
-				element->next = head;
-
-				// add to head
-				if(isEmpty())
-				{
-					tail = element;
-				}
-				else
-				{
-					head->prev = element;
-				}
-
-				head = element;
-			}
-			else if(index == length)
-			{
-				// add to tail
-				tail->next = element;
-				element->prev = tail;
-				tail = element;
-			}
-			else
-			{
-				// add to middle
-				addIter(0,index,element, head);
-			}
-
-			length++;
+			// this will push the link at the current index to the next index
+			insertBefore(index == length ? NULL : linkAt(index), element);
 		}
 		else
 		{
-			delete element;
+			LinkPool<type>::release(element);
 			cout << endl << "**** Index out of bounds ****" << endl;
 		}
 	}
@@ -280,27 +300,48 @@ void List<type> :: add(int index,const type& newElement)
 
 
 /**************************************************************************
- * METHOD addIter
+ * METHOD insertBefore
  * ------------------------------------------------------------------------
- * This is an iterative helper method for add middle.
+ * This method links element into the list in front of node in O(1). A NULL
+ * node appends element to the tail. The access cache stays valid when the
+ * element goes on either end of the list.
  *************************************************************************/
 template<class type>
-void List<type> :: addIter(int i, int n, Link<type> *element, Link<type> *node)
+void List<type> :: insertBefore(Link<type> *node, Link<type> *element)
 {
-	if(i != n)
+	element->next = node;
+	element->prev = node ? node->prev : tail;
+
+	if(element->prev != NULL)
 	{
-		addIter(i + 1, n, element, node->next);
+		element->prev->next = element;
 	}
 	else
 	{
-		// add element to middle of the list
-		//
-		// this will push the node at the current index to the next index
-		node->prev->next = element;
-		element->prev = node->prev;
+		head = element;
+	}
+
+	if(node != NULL)
+	{
 		node->prev = element;
-		element->next = node;
 	}
+	else
+	{
+		tail = element;
+	}
+
+	// UPDATE - cache index shifts when the element lands in front of it
+	if(element == head && cacheIndex >= 0)
+	{
+		cacheIndex++;
+	}
+	else if(element != tail)
+	{
+		cacheIndex = -1;
+	}
+
+	// COUNT - add 1 to list size
+	length++;
 }
 
 
@@ -315,7 +356,7 @@ void List<type> :: push(const type& newElement)
 	Link<type> *node; // ITERATOR - traverses the list
 
 	// INITIALIZE
-	node = new Link<type>;
+	node = LinkPool<type>::acquire();
 
 	// IF - fails if there is no available memory
 	if(node != NULL)
@@ -338,6 +379,12 @@ void List<type> :: push(const type& newElement)
 			head = node;
 		}
 
+		// UPDATE - the cached link moved one index back
+		if (cacheIndex >= 0)
+		{
+			cacheIndex++;
+		}
+
 		// REINITIALIZE
 		node = NULL;
 
@@ -377,14 +424,28 @@ type List<type> :: pop()
 			head->prev = NULL;
 		}
 
+		// UPDATE - the cached link moved one index forward
+		if (cache == popped)
+		{
+			cacheIndex = -1;
+		}
+		else if (cacheIndex >= 0)
+		{
+			cacheIndex--;
+		}
+
 		// COUNT - subtract 1 to list size
 		length--;
-		return popped->item;
+
+		// FREE - the link goes back to the pool once its item is copied out
+		type item = popped->item;
+		LinkPool<type>::release(popped);
+		return item;
 	}
 	else
 	{
 		cout << "\n**** You cannot remove from an empty list ****\n";
-		return NULL;
+		return type();
 	}
 }
 
@@ -400,7 +461,9 @@ void List<type> :: remove(int index)
 {
 	if(inRange(index))
 	{
-		removeIter(0, index, head);
+		Link<type> *node = linkAt(index);
+		unlink(node);
+		LinkPool<type>::release(node);
 	}
 	else
 	{
@@ -411,60 +474,55 @@ void List<type> :: remove(int index)
 
 
 /*******************************************************************************
- * METHOD removeIter
+ * METHOD unlink
  * -----------------------------------------------------------------------------
- * This is a helper method for remove.
+ * This method takes a link off the list in O(1) and leaves it to the caller
+ * to delete.
  ******************************************************************************/
 template<class type>
-void List<type> :: removeIter(int i, int n, Link<type> *node)
+void List<type> :: unlink(Link<type> *node)
 {
-	if(i < n)
+	// UPDATE - removing the head shifts every index down, removing the tail
+	//          moves nothing, anything else may have moved the cache
+	if(cache == node)
 	{
-		getIter(i+1,n,node->next);
+		cacheIndex = -1;
 	}
-	else
+	else if(node->prev == NULL)
 	{
-		if(node->prev != NULL)
+		if(cacheIndex >= 0)
 		{
-			if(node->next != NULL)
-			{
-				// Remove link not on head or tail
-				node->prev->next = node->next;
-				node->next->prev = node->prev;
-				node->prev = NULL;
-				node->next = NULL;
-			}
-			else
-			{
-				// Remove link on the tail
-				tail = node->prev;
-				tail->next = NULL;
-				node->prev = NULL;
-			}
-		}
-		else
-		{
-			if(node->next != NULL)
-			{
-				// Remove link on head
-				head = node->next;
-				head->prev = NULL;
-				node->next = NULL;
-			}
-			else
-			{
-				// Remove last node
-				head = NULL;
-				tail = NULL;
-			}
+			cacheIndex--;
 		}
+	}
+	else if(node->next != NULL)
+	{
+		cacheIndex = -1;
+	}
 
-		delete node;
-		node = NULL;
+	if(node->prev != NULL)
+	{
+		node->prev->next = node->next;
+	}
+	else
+	{
+		head = node->next;
+	}
 
-		// COUNT - subtract 1 to list size
-		length--;
+	if(node->next != NULL)
+	{
+		node->next->prev = node->prev;
+	}
+	else
+	{
+		tail = node->prev;
 	}
+
+	node->prev = NULL;
+	node->next = NULL;
+
+	// COUNT - subtract 1 to list size
+	length--;
 }
 
 
@@ -478,7 +536,7 @@ type List<type> :: getNode(int index)
 {
 	if(inRange(index))
 	{
-		return getNodeIter(0, index, head);
+		return linkAt(index)->item;
 	}
 	else
 	{
@@ -489,25 +547,6 @@ type List<type> :: getNode(int index)
 }
 
 
-/*******************************************************************************
- * METHOD getNodeIter
- * -----------------------------------------------------------------------------
- * Helper method for get.
- ******************************************************************************/
-template<class type>
-type List<type> :: getNodeIter(int i, int n, Link<type> *node)
-{
-	if(i < n)
-	{
-		return getNodeIter(i+1,n,node->next);
-	}
-	else
-	{
-		return node->item;
-	}
-}
-
-
 /*******************************************************************************
  * METHOD get
  * -----------------------------------------------------------------------------
@@ -519,7 +558,7 @@ Link<type>* List<type> :: get(int index)
 {
 	if(inRange(index))
 	{
-		return getIter(0, index, head);
+		return linkAt(index);
 	}
 	else if(index == 0)
 	{
@@ -534,21 +573,52 @@ Link<type>* List<type> :: get(int index)
 
 
 /*******************************************************************************
- * METHOD getNodeIter
+ * METHOD linkAt
  * -----------------------------------------------------------------------------
- * Helper method for get.
+ * This method walks to a link from whichever of the head, the tail and the
+ * last accessed link is closest, then remembers where it stopped. Walking a
+ * list by index, forward or backward, therefore costs O(1) per step rather
+ * than O(index).
  ******************************************************************************/
 template<class type>
-Link<type>* List<type> :: getIter(int i, int n, Link<type> *node)
+Link<type>* List<type> :: linkAt(int index)
 {
-	if(i < n)
+	Link<type> *node;
+	int i;
+
+	// START - from the closer end
+	if(index <= length - 1 - index)
 	{
-		return getIter(i+1,n,node->next);
+		node = head;
+		i = 0;
 	}
 	else
 	{
-		return node;
+		node = tail;
+		i = length - 1;
+	}
+
+	// START - from the cache when it is closer still
+	if(cacheIndex >= 0 && abs(index - cacheIndex) < abs(index - i))
+	{
+		node = cache;
+		i = cacheIndex;
+	}
+
+	while(i < index)
+	{
+		node = node->next;
+		i++;
+	}
+	while(i > index)
+	{
+		node = node->prev;
+		i--;
 	}
+
+	cache = node;
+	cacheIndex = index;
+	return node;
 }
 
 
@@ -561,38 +631,22 @@ Link<type>* List<type> :: getIter(int i, int n, Link<type> *node)
 template<class type>
 bool List<type> :: contains(type item)
 {
-	return containsIter(0, item, false, head);
-}
-
-
-/*******************************************************************************
- * METHOD containsIter
- * -----------------------------------------------------------------------------
- * Helper method for contains.
- ******************************************************************************/
-template<class type>
-bool List<type> :: containsIter(int i, type item, bool contains, Link<type> *node)
-{
-	if(i < length)
+	for(Link<type> *node = head; node != NULL; node = node->next)
 	{
 		if(node->item == item)
 		{
 			return true;
 		}
-
-		return containsIter(i+1, item, false, node->next);
-	}
-	else
-	{
-		return false;
 	}
+
+	return false;
 }
 
 
 template<class type>
 type List<type> :: peek()
 {
-	return isEmpty() ? NULL : head->item;
+	return isEmpty() ? type() : head->item;
 }
 
 
@@ -618,7 +672,10 @@ void List<type> :: print()
 {
 	if(!isEmpty())
 	{
-		printIter(head);
+		for(Link<type> *node = head; node != NULL; node = node->next)
+		{
+			cout << " " << node->item;
+		}
 	}
 	else
 	{
@@ -628,19 +685,278 @@ void List<type> :: print()
 
 
 /*******************************************************************************
- * METHOD printIter
+ * METHOD splice
  * -----------------------------------------------------------------------------
- * This is a helper method for print.
+ * This method moves every link of other in front of pos, leaving other
+ * empty. Only the links at the two seams are touched, so nothing is
+ * allocated or copied whatever the length of other.
  ******************************************************************************/
 template<class type>
-void List<type> :: printIter(Link<type> *node)
+void List<type> :: splice(ListIter<type> pos, List<type>& other)
 {
+	if(&other == this || other.isEmpty())
+	{
+		return;
+	}
+
+	spliceChain(pos.link(), other.head, other.tail, other.length);
+
+	other.head = NULL;
+	other.tail = NULL;
+	other.length = 0;
+	other.cacheIndex = -1;
+}
+
+
+/*******************************************************************************
+ * METHOD splice
+ * -----------------------------------------------------------------------------
+ * This method moves the links of other from first up to, but not including,
+ * last in front of pos. A past the end last takes everything to other's
+ * tail. Relinking is O(1); the length of the range is counted unless the
+ * caller passes it in count. other may be this list as long as pos is not
+ * inside the range.
+ ******************************************************************************/
+template<class type>
+void List<type> :: splice(ListIter<type> pos, List<type>& other,
+                          ListIter<type> first, ListIter<type> last, int count)
+{
+	Link<type> *begin = first.link();
+	Link<type> *end = last.link();
+
+	if(begin == NULL || begin == end)
+	{
+		return;
+	}
+
+	Link<type> *back = end ? end->prev : other.tail;
+
+	// COUNT - only when the caller did not
+	if(count < 0)
+	{
+		count = 1;
+		for(Link<type> *node = begin; node != back; node = node->next)
+		{
+			count++;
+		}
+	}
+
+	// UNLINK - the range from other
+	if(begin->prev != NULL)
+	{
+		begin->prev->next = end;
+	}
+	else
+	{
+		other.head = end;
+	}
+
+	if(end != NULL)
+	{
+		end->prev = begin->prev;
+	}
+	else
+	{
+		other.tail = begin->prev;
+	}
+
+	other.length -= count;
+	other.cacheIndex = -1;
+
+	spliceChain(pos.link(), begin, back, count);
+}
+
+
+/*******************************************************************************
+ * METHOD spliceChain
+ * -----------------------------------------------------------------------------
+ * This method links an unattached chain of count links, first through last,
+ * in front of node, or at the tail when node is NULL.
+ ******************************************************************************/
+template<class type>
+void List<type> :: spliceChain(Link<type> *node, Link<type> *first, Link<type> *last, int count)
+{
+	first->prev = node ? node->prev : tail;
+	last->next = node;
+
+	if(first->prev != NULL)
+	{
+		first->prev->next = first;
+	}
+	else
+	{
+		head = first;
+	}
+
 	if(node != NULL)
 	{
-		cout << " " << node->item;
-		printIter(node->next);
+		node->prev = last;
 	}
+	else
+	{
+		tail = last;
+	}
+
+	length += count;
+	cacheIndex = -1;
 }
 
 
+/*******************************************************************************
+ * METHOD merge
+ * -----------------------------------------------------------------------------
+ * This method merges other, sorted by operator <, into this sorted list and
+ * leaves other empty. On equal items this list's links come first.
+ ******************************************************************************/
+template<class type>
+void List<type> :: merge(List<type>& other)
+{
+	if(&other == this || other.isEmpty())
+	{
+		return;
+	}
+
+	head = mergeChains(head, other.head);
+	length += other.length;
+	relink();
+
+	other.head = NULL;
+	other.tail = NULL;
+	other.length = 0;
+	other.cacheIndex = -1;
+}
+
+
+/*******************************************************************************
+ * METHOD sort
+ * -----------------------------------------------------------------------------
+ * This method sorts the list by operator < with a bottom-up merge sort on
+ * the links themselves. bins[i] holds a sorted run of 2^i links; each link
+ * is carried up through the full bins like a binary counter, then the bins
+ * are merged oldest first so that equal items keep their order.
+ ******************************************************************************/
+template<class type>
+void List<type> :: sort()
+{
+	Link<type> *bins[64] = { NULL };
+	Link<type> *node = head;
+
+	while(node != NULL)
+	{
+		Link<type> *next = node->next;
+		Link<type> *carry = node;
+		int i = 0;
+
+		node->next = NULL;
+		while(bins[i] != NULL)
+		{
+			carry = mergeChains(bins[i], carry);
+			bins[i] = NULL;
+			i++;
+		}
+		bins[i] = carry;
+		node = next;
+	}
+
+	head = NULL;
+	for(int i = 0; i < 64; i++)
+	{
+		if(bins[i] != NULL)
+		{
+			head = head ? mergeChains(bins[i], head) : bins[i];
+		}
+	}
+	relink();
+}
+
+
+/*******************************************************************************
+ * METHOD reverse
+ * -----------------------------------------------------------------------------
+ * This method reverses the list by swapping each link's next and prev.
+ ******************************************************************************/
+template<class type>
+void List<type> :: reverse()
+{
+	Link<type> *node = head;
+
+	while(node != NULL)
+	{
+		Link<type> *next = node->next;
+		node->next = node->prev;
+		node->prev = next;
+		node = next;
+	}
+
+	node = head;
+	head = tail;
+	tail = node;
+	cacheIndex = -1;
+}
+
+
+/*******************************************************************************
+ * METHOD mergeChains
+ * -----------------------------------------------------------------------------
+ * This method merges two sorted chains linked through next only. Ties are
+ * taken from a first.
+ ******************************************************************************/
+template<class type>
+Link<type>* List<type> :: mergeChains(Link<type> *a, Link<type> *b)
+{
+	Link<type> *merged = NULL;
+	Link<type> **end = &merged;
+
+	while(a != NULL && b != NULL)
+	{
+		if(b->item < a->item)
+		{
+			*end = b;
+			b = b->next;
+		}
+		else
+		{
+			*end = a;
+			a = a->next;
+		}
+		end = &(*end)->next;
+	}
+	*end = a ? a : b;
+
+	return merged;
+}
+
+
+/*******************************************************************************
+ * METHOD relink
+ * -----------------------------------------------------------------------------
+ * This method walks the next chain from head to restore every prev pointer
+ * and the tail after the chain has been rearranged.
+ ******************************************************************************/
+template<class type>
+void List<type> :: relink()
+{
+	Link<type> *prev = NULL;
+
+	for(Link<type> *node = head; node != NULL; node = node->next)
+	{
+		node->prev = prev;
+		prev = node;
+	}
+
+	tail = prev;
+	cacheIndex = -1;
+}
+
+
+// ITERATORS - need the complete List, so they are defined after it
+#include "ListIter.h"
+
+#ifdef LIST_CONTIGUOUS
+#undef List
+template<class type>
+using List = Sequence<type>;
+#endif
+
+
 #endif /* LIST_H_ */
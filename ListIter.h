@@ -3,22 +3,52 @@
  * DATE       : 9/10/2015
  ******************************************************************************/
 #ifndef LISTITER_H_
-#define LISTITER_H_
+#ifndef LIST_H_
 
+// List.h includes this header back once List is complete
 #include "List.h"
+
+#else
+#define LISTITER_H_
+
 #include <iostream>
+#include <iterator>
+#include <cstddef>
 using namespace std;
 
+/*******************************************************************************
+ * CLASS ListIter
+ * -----------------------------------------------------------------------------
+ * This class is a bidirectional iterator over the links of a List. Past the
+ * tail it holds a NULL link, which is what List::end returns, and stepping
+ * back from there lands on the tail. Stepping does no bounds checking, so
+ * range-for and <algorithm> loops cost a pointer load per item.
+ ******************************************************************************/
 template <class type>
 class ListIter {
 
 private:
+	friend class ListConstIter<type>;
+
+	List<type>* list;
 	Link<type>* ptr;
 
 public:
 
+	typedef bidirectional_iterator_tag iterator_category;
+	typedef type                       value_type;
+	typedef ptrdiff_t                  difference_type;
+	typedef type*                      pointer;
+	typedef type&                      reference;
+
+	ListIter();
+		// Singular iterator, only good to be assigned to
+
 	ListIter(List<type> *list);
 
+	ListIter(List<type> *list, Link<type> *ptr);
+		// Construct iterator to a link of list, NULL for the end
+
 	ListIter(List<type>& list);
 		// Default constructor
 
@@ -34,26 +64,121 @@ public:
 	void prev();
 		// POST: ptr goes to previous link on list
 
+	void insert(const type& item);
+		// POST: item is linked in before ptr, or at the tail when ptr is
+		//       past the end, in O(1)
+
+	void erase();
+		// POST: the link at ptr is removed in O(1) and ptr goes to the
+		//       next link on list
+
+	Link<type>* link();
+		// POST: the link at ptr, NULL past the end
+
+	type& operator*() const;
+	type* operator->() const;
+
+	ListIter<type>& operator++();
+	ListIter<type>  operator++(int);
+		// POST: ptr goes to next link on list
+
+	ListIter<type>& operator--();
+	ListIter<type>  operator--(int);
+		// POST: ptr goes to previous link on list, the tail from the end
+
+	friend bool operator==(const ListIter<type>& a, const ListIter<type>& b) {
+		return a.ptr == b.ptr;
+	}
+
+	friend bool operator!=(const ListIter<type>& a, const ListIter<type>& b) {
+		return a.ptr != b.ptr;
+	}
+
+};
+
+
+/*******************************************************************************
+ * CLASS ListConstIter
+ * -----------------------------------------------------------------------------
+ * This class is the read-only counterpart of ListIter, returned by begin and
+ * end on a const List. A ListIter converts to it, so the two compare freely.
+ ******************************************************************************/
+template <class type>
+class ListConstIter {
+
+private:
+	const List<type>* list;
+	const Link<type>* ptr;
+
+public:
+
+	typedef bidirectional_iterator_tag iterator_category;
+	typedef type                       value_type;
+	typedef ptrdiff_t                  difference_type;
+	typedef const type*                pointer;
+	typedef const type&                reference;
+
+	ListConstIter();
+
+	ListConstIter(const List<type> *list, const Link<type> *ptr);
+
+	ListConstIter(const ListIter<type>& other);
+
+	const type& operator*() const;
+	const type* operator->() const;
+
+	ListConstIter<type>& operator++();
+	ListConstIter<type>  operator++(int);
+
+	ListConstIter<type>& operator--();
+	ListConstIter<type>  operator--(int);
+
+	friend bool operator==(const ListConstIter<type>& a, const ListConstIter<type>& b) {
+		return a.ptr == b.ptr;
+	}
+
+	friend bool operator!=(const ListConstIter<type>& a, const ListConstIter<type>& b) {
+		return a.ptr != b.ptr;
+	}
+
 };
 
 
+template <class type>
+ListIter<type> :: ListIter() {
+
+	list = NULL;
+	ptr = NULL;
+}
+
+
 template <class type>
 ListIter<type> :: ListIter(List<type> *list)
 {
+	this->list = list;
 	ptr = list->get(0);
 }
 
 
+template <class type>
+ListIter<type> :: ListIter(List<type> *list, Link<type> *ptr) {
+
+	this->list = list;
+	this->ptr = ptr;
+}
+
 template <class type>
 ListIter<type> :: ListIter(List<type>& list) {
 
+	this->list = &list;
 	ptr = list.get(0);
 }
 
 template <class type>
 ListIter<type> :: ListIter(List<type>& list, int index) {
 
-	ptr = list->get(index);
+	this->list = &list;
+	ptr = list.get(index);
 }
 
 template <class type>
@@ -73,4 +198,145 @@ void ListIter<type> :: prev() {
 	ptr = ptr->prev;
 }
 
+template <class type>
+void ListIter<type> :: insert(const type& item) {
+
+	Link<type> *element = LinkPool<type>::acquire();
+	element->item = item;
+	list->insertBefore(ptr, element);
+}
+
+template <class type>
+void ListIter<type> :: erase() {
+
+	Link<type> *node = ptr;
+	ptr = ptr->next;
+	list->unlink(node);
+	LinkPool<type>::release(node);
+}
+
+template <class type>
+Link<type>* ListIter<type> :: link() {
+	return ptr;
+}
+
+template <class type>
+type& ListIter<type> :: operator*() const {
+	return ptr->item;
+}
+
+template <class type>
+type* ListIter<type> :: operator->() const {
+	return &ptr->item;
+}
+
+template <class type>
+ListIter<type>& ListIter<type> :: operator++() {
+	ptr = ptr->next;
+	return *this;
+}
+
+template <class type>
+ListIter<type> ListIter<type> :: operator++(int) {
+	ListIter<type> old = *this;
+	ptr = ptr->next;
+	return old;
+}
+
+template <class type>
+ListIter<type>& ListIter<type> :: operator--() {
+	ptr = ptr ? ptr->prev : list->tail;
+	return *this;
+}
+
+template <class type>
+ListIter<type> ListIter<type> :: operator--(int) {
+	ListIter<type> old = *this;
+	ptr = ptr ? ptr->prev : list->tail;
+	return old;
+}
+
+
+template <class type>
+ListConstIter<type> :: ListConstIter() {
+
+	list = NULL;
+	ptr = NULL;
+}
+
+template <class type>
+ListConstIter<type> :: ListConstIter(const List<type> *list, const Link<type> *ptr) {
+
+	this->list = list;
+	this->ptr = ptr;
+}
+
+template <class type>
+ListConstIter<type> :: ListConstIter(const ListIter<type>& other) {
+
+	list = other.list;
+	ptr = other.ptr;
+}
+
+template <class type>
+const type& ListConstIter<type> :: operator*() const {
+	return ptr->item;
+}
+
+template <class type>
+const type* ListConstIter<type> :: operator->() const {
+	return &ptr->item;
+}
+
+template <class type>
+ListConstIter<type>& ListConstIter<type> :: operator++() {
+	ptr = ptr->next;
+	return *this;
+}
+
+template <class type>
+ListConstIter<type> ListConstIter<type> :: operator++(int) {
+	ListConstIter<type> old = *this;
+	ptr = ptr->next;
+	return old;
+}
+
+template <class type>
+ListConstIter<type>& ListConstIter<type> :: operator--() {
+	ptr = ptr ? ptr->prev : list->tail;
+	return *this;
+}
+
+template <class type>
+ListConstIter<type> ListConstIter<type> :: operator--(int) {
+	ListConstIter<type> old = *this;
+	ptr = ptr ? ptr->prev : list->tail;
+	return old;
+}
+
+
+/*******************************************************************************
+ * METHOD begin / end
+ ******************************************************************************/
+template <class type>
+ListIter<type> List<type> :: begin() {
+	return ListIter<type>(this, head);
+}
+
+template <class type>
+ListIter<type> List<type> :: end() {
+	return ListIter<type>(this, NULL);
+}
+
+template <class type>
+ListConstIter<type> List<type> :: begin() const {
+	return ListConstIter<type>(this, head);
+}
+
+template <class type>
+ListConstIter<type> List<type> :: end() const {
+	return ListConstIter<type>(this, NULL);
+}
+
+#endif /* LIST_H_ */
 #endif /* LISTITER_H_ */
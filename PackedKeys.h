@@ -0,0 +1,290 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef PACKEDKEYS_H_
+#define PACKEDKEYS_H_
+
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+#include "AVL.h"
+#include "AVLIter.h"
+using namespace std;
+
+
+/*******************************************************************************
+ * CLASS - PackedKeys
+ * -----------------------------------------------------------------------------
+ * This class is a frozen copy of the keys of a tree, packed for size. Keys
+ * are cut into blocks of BLOCK in key order. Each block stores its keys as
+ * offsets from its first key, all of them in the fewest bits that hold the
+ * largest offset (frame of reference), so a block of dense keys takes about
+ * a byte per key and a block of keys spread over the whole int range at a
+ * million keys takes under three.
+ *
+ * The offsets of a block are stored in four interleaved lanes, SIMD-BP128
+ * style: offset i goes to lane i % 4, and word j of lane l is word 4j + l of
+ * the block. The four offsets 4p to 4p + 3 then sit at the same bit position
+ * of four neighbouring words, so one 128 bit load and shifts by one count
+ * for all four lanes decode them together; SSE2 has exactly those shifts,
+ * and the unpack loop compiles to them.
+ *
+ * A lookup binary searches the first keys of the blocks, which sit together
+ * in one small array, and then binary searches inside one block. Any offset
+ * can be read straight out of its block with one shift and one mask, so the
+ * search never unpacks the block. Scans unpack a whole block at a time.
+ *
+ * Keys are numbered 0 to size() - 1 in order, so items can be kept in an
+ * array beside the keys and found through indexOf.
+ ******************************************************************************/
+class PackedKeys
+{
+public:
+
+	static const int BLOCK = 128;
+
+	PackedKeys();
+
+	template<class type>
+	void build(AVL<type>& tree);
+		// POST: holds the keys of tree
+	void build(const int *keys, long count);
+		// PRE:  keys strictly increasing
+		// POST: holds keys
+
+	bool contains(int id);
+	long indexOf(int id);
+		// POST: number of keys below id if id is held, -1 if not
+	long lowerBound(int id);
+		// POST: number of keys below id
+	int  at(long i);
+		// PRE:  0 <= i < size()
+
+	template<class Visit>
+	void forEach(Visit visit);
+		// POST: visit(id) called for every key in order
+
+	long size();
+	long bytes();
+		// POST: bytes held by the packed keys and their index
+
+private:
+
+	struct Block
+	{
+		uint32_t word;   // CALC - first word of the block's bits
+		uint32_t width;  // CALC - bits per offset, 0 to 32
+	};
+
+	long             count;
+	vector<int>      firsts;  // CALC - first key of each block
+	vector<Block>    blocks;
+	vector<uint32_t> words;   // CALC - every block's offsets, bit packed
+
+	uint32_t offset(const Block& block, int i);
+	void     unpack(long b, int *out);
+	int      blockSize(long b);
+
+	static void unpackLanes(const uint32_t * __restrict base, uint32_t first,
+	                        uint32_t width, int * __restrict out);
+};
+
+
+inline PackedKeys :: PackedKeys()
+{
+	count = 0;
+}
+
+inline long PackedKeys :: size()
+{
+	return count;
+}
+
+inline long PackedKeys :: bytes()
+{
+	return firsts.capacity() * sizeof(int) + blocks.capacity() * sizeof(Block)
+	     + words.capacity() * sizeof(uint32_t);
+}
+
+inline int PackedKeys :: blockSize(long b)
+{
+	return (int)min((long)BLOCK, count - b * BLOCK);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - build
+ * -----------------------------------------------------------------------------
+ * Each block's width comes from its last key, the largest offset, and the
+ * block takes 4 * width words whatever its size, the unused slots of a short
+ * last block left zero. Eight spare words at the end let offset and unpack
+ * read one group of four words past any block.
+ ******************************************************************************/
+template<class type>
+void PackedKeys :: build(AVL<type>& tree)
+{
+	vector<int> keys;
+
+	for (AVLIter<type> it = tree.begin(); it != tree.end(); ++it)
+		keys.push_back(it.id());
+	build(keys.empty() ? NULL : &keys[0], keys.size());
+}
+
+inline void PackedKeys :: build(const int *keys, long n)
+{
+	long blockCount = (n + BLOCK - 1) / BLOCK;
+	uint64_t used = 0;
+
+	count = n;
+	firsts.assign(blockCount, 0);
+	blocks.assign(blockCount, Block());
+
+	for (long b = 0; b < blockCount; ++b)
+	{
+		const int *block = keys + b * BLOCK;
+		int       size   = blockSize(b);
+		uint32_t  span   = (uint32_t)block[size - 1] - (uint32_t)block[0];
+		uint32_t  width  = 0;
+
+		while (width < 32 && (span >> width))
+			++width;
+
+		firsts[b]       = block[0];
+		blocks[b].word  = (uint32_t)used;
+		blocks[b].width = width;
+		used += 4 * width;
+	}
+
+	words.assign(used + 8, 0);
+	for (long b = 0; b < blockCount; ++b)
+	{
+		const int *block = keys + b * BLOCK;
+		uint32_t   width = blocks[b].width;
+		uint32_t  *base  = &words[blocks[b].word];
+
+		for (int i = 0; i < blockSize(b); ++i)
+		{
+			uint32_t value = (uint32_t)block[i] - (uint32_t)block[0];
+			uint32_t bit   = (i / 4) * width;
+			uint32_t *lane = base + 4 * (bit / 32) + i % 4;
+
+			lane[0] |= value << (bit % 32);
+			if (bit % 32 + width > 32)
+				lane[4] |= value >> (32 - bit % 32);
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - offset / at
+ ******************************************************************************/
+inline uint32_t PackedKeys :: offset(const Block& block, int i)
+{
+	uint32_t bit  = (i / 4) * block.width;
+	uint64_t mask = ((uint64_t)1 << block.width) - 1;
+	const uint32_t *lane = &words[block.word + 4 * (bit / 32) + i % 4];
+	uint64_t pair = lane[0] | (uint64_t)lane[4] << 32;
+
+	return (uint32_t)((pair >> (bit % 32)) & mask);
+}
+
+inline int PackedKeys :: at(long i)
+{
+	long b = i / BLOCK;
+	return (int)((uint32_t)firsts[b] + offset(blocks[b], (int)(i % BLOCK)));
+}
+
+
+/*******************************************************************************
+ * FUNCTION - lowerBound / indexOf / contains
+ * -----------------------------------------------------------------------------
+ * The block is the last one whose first key is not above id. Inside it the
+ * search compares offsets rather than keys, which saves adding the base back
+ * on every probe.
+ ******************************************************************************/
+inline long PackedKeys :: lowerBound(int id)
+{
+	if (count == 0 || id <= firsts[0])
+		return 0;
+
+	long b = upper_bound(firsts.begin(), firsts.end(), id) - firsts.begin() - 1;
+	const Block &block = blocks[b];
+	uint32_t target = (uint32_t)id - (uint32_t)firsts[b];
+
+	int low  = 0;
+	int high = blockSize(b);
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		if (offset(block, mid) < target)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return b * BLOCK + low;
+}
+
+inline long PackedKeys :: indexOf(int id)
+{
+	long i = lowerBound(id);
+	return i < count && at(i) == id ? i : -1;
+}
+
+inline bool PackedKeys :: contains(int id)
+{
+	return indexOf(id) >= 0;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - unpack / forEach
+ * -----------------------------------------------------------------------------
+ * unpackLanes decodes all BLOCK slots of a block, four lanes per step. Within
+ * a step the shift and mask are the same for every lane and only the step
+ * decides whether an offset runs on into the next word, so the four lane
+ * loops vectorize; GCC emits them as psrld, pslld, pand and paddd at -O2.
+ * The restrict qualifiers tell it out cannot alias the packed words.
+ ******************************************************************************/
+inline void PackedKeys :: unpackLanes(const uint32_t * __restrict base, uint32_t first,
+                                      uint32_t width, int * __restrict out)
+{
+	uint32_t mask = width == 32 ? ~0u : (1u << width) - 1;
+
+	for (int step = 0; step < BLOCK / 4; ++step, out += 4)
+	{
+		uint32_t bit   = step * width;
+		uint32_t shift = bit % 32;
+		const uint32_t *lane = base + 4 * (bit / 32);
+
+		if (shift + width > 32)
+			for (int l = 0; l < 4; ++l)
+				out[l] = (int)(first + (((lane[l] >> shift) | (lane[l + 4] << (32 - shift))) & mask));
+		else
+			for (int l = 0; l < 4; ++l)
+				out[l] = (int)(first + ((lane[l] >> shift) & mask));
+	}
+}
+
+inline void PackedKeys :: unpack(long b, int *out)
+{
+	unpackLanes(&words[blocks[b].word], (uint32_t)firsts[b], blocks[b].width, out);
+}
+
+template<class Visit>
+void PackedKeys :: forEach(Visit visit)
+{
+	int keys[BLOCK];
+
+	for (long b = 0; b < (long)blocks.size(); ++b)
+	{
+		unpack(b, keys);
+		for (int i = 0; i < blockSize(b); ++i)
+			visit(keys[i]);
+	}
+}
+
+
+#endif /* PACKEDKEYS_H_ */
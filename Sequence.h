@@ -0,0 +1,305 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef SEQUENCE_H_
+#define SEQUENCE_H_
+
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <deque>
+using namespace std;
+
+/*******************************************************************************
+ * STRUCT Slot
+ * -----------------------------------------------------------------------------
+ * This template struct holds one item of a Sequence. It stands in for the
+ * Link struct so that code written as list.get(i)->item works on either.
+ ******************************************************************************/
+template <class type>
+struct Slot
+{
+	type item; // CALC - item contained in each slot
+};
+
+/*******************************************************************************
+ * CLASS SlotIter
+ * -----------------------------------------------------------------------------
+ * This class steps through the slots of a Sequence and yields their items,
+ * so loops over a Sequence read the same as loops over a List. Value is
+ * type or const type and Base the matching deque iterator.
+ ******************************************************************************/
+template <class Value, class Base>
+class SlotIter
+{
+public:
+
+	typedef bidirectional_iterator_tag iterator_category;
+	typedef typename remove_const<Value>::type value_type;
+	typedef ptrdiff_t                  difference_type;
+	typedef Value*                     pointer;
+	typedef Value&                     reference;
+
+	SlotIter() {}
+	SlotIter(Base at) : at(at) {}
+
+	template <class V, class B>
+	SlotIter(const SlotIter<V, B>& other) : at(other.base()) {}
+
+	Value& operator*() const { return at->item; }
+	Value* operator->() const { return &at->item; }
+
+	SlotIter& operator++() { ++at; return *this; }
+	SlotIter  operator++(int) { SlotIter old = *this; ++at; return old; }
+	SlotIter& operator--() { --at; return *this; }
+	SlotIter  operator--(int) { SlotIter old = *this; --at; return old; }
+
+	bool operator==(const SlotIter& other) const { return at == other.at; }
+	bool operator!=(const SlotIter& other) const { return at != other.at; }
+
+	Base base() const { return at; }
+
+private:
+	Base at; // POINT - to the current slot
+};
+
+/*******************************************************************************
+ * CLASS Sequence
+ * -----------------------------------------------------------------------------
+ * This class offers the List interface on contiguous storage. Items live in
+ * a chunked deque, so indexing is O(1), neighbouring items share cache lines
+ * and adding or removing at either end never moves the other items. Adding
+ * or removing in the middle shifts items like any array does.
+ *
+ * Defining LIST_CONTIGUOUS before List.h is included makes List<type> this
+ * class, so existing users switch storage without code changes.
+ ******************************************************************************/
+template<class type>
+class Sequence
+{
+public:
+
+	typedef SlotIter<type, typename deque<Slot<type> >::iterator>             iterator;
+	typedef SlotIter<const type, typename deque<Slot<type> >::const_iterator> const_iterator;
+
+	bool isEmpty();
+		// checks if sequence is empty
+
+	bool inRange(int x);
+		// checks if x is a valid index
+
+	void add(const type& newElement);
+		// adds an item to the tail
+
+	void add(int index,const type& newElement);
+		// adds an item to middle of sequence
+
+	void push(const type& newElement);
+		// adds an item to the head
+
+	type pop();
+		// removes an item from the head
+
+	void remove(int index);
+		// removes an item at index
+
+	void print();
+		// prints the entire sequence
+
+	type getNode(int index);
+		// returns a copy of an item at index
+
+	Slot<type>* get(int index);
+		// returns a pointer to a slot in the sequence
+
+	int size();
+		// gets the size of the sequence
+
+	bool contains(type item);
+		// checks if an item is already in the sequence
+
+	type peek();
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+		// iterators over the items, end is one past the last
+
+private:
+
+	deque<Slot<type> > slots; // items of the sequence in order
+};
+
+
+template<class type>
+bool Sequence<type> :: isEmpty()
+{
+	return slots.empty();
+}
+
+template<class type>
+bool Sequence<type> :: inRange(int x)
+{
+	return (x >= 0 && x < (int)slots.size());
+}
+
+template<class type>
+void Sequence<type> :: add(const type& newElement)
+{
+	Slot<type> slot = { newElement };
+	slots.push_back(slot);
+}
+
+template<class type>
+void Sequence<type> :: add(int index, const type& newElement)
+{
+	if(index >= 0 && index <= (int)slots.size())
+	{
+		Slot<type> slot = { newElement };
+		slots.insert(slots.begin() + index, slot);
+	}
+	else
+	{
+		cout << endl << "**** Index out of bounds ****" << endl;
+	}
+}
+
+template<class type>
+void Sequence<type> :: push(const type& newElement)
+{
+	Slot<type> slot = { newElement };
+	slots.push_front(slot);
+}
+
+template<class type>
+type Sequence<type> :: pop()
+{
+	if(!isEmpty())
+	{
+		type item = slots.front().item;
+		slots.pop_front();
+		return item;
+	}
+	else
+	{
+		cout << "\n**** You cannot remove from an empty list ****\n";
+		return type();
+	}
+}
+
+template<class type>
+void Sequence<type> :: remove(int index)
+{
+	if(inRange(index))
+	{
+		slots.erase(slots.begin() + index);
+	}
+	else
+	{
+		cout << "\n****The node you want to delete is out of "
+						"bounds.****\n";
+	}
+}
+
+template<class type>
+void Sequence<type> :: print()
+{
+	if(!isEmpty())
+	{
+		for(size_t i = 0; i < slots.size(); ++i)
+		{
+			cout << " " << slots[i].item;
+		}
+	}
+	else
+	{
+		cout << endl << "List is Empty" << endl;
+	}
+}
+
+template<class type>
+type Sequence<type> :: getNode(int index)
+{
+	if(inRange(index))
+	{
+		return slots[index].item;
+	}
+	else
+	{
+		cout << "\n**** The node you wish to see is out of bounds ****\n";
+		return type();
+	}
+}
+
+template<class type>
+Slot<type>* Sequence<type> :: get(int index)
+{
+	if(inRange(index))
+	{
+		return &slots[index];
+	}
+	else if(index == 0)
+	{
+		return NULL;
+	}
+	else
+	{
+		cout << "\n**** The node you wish to see is out of bounds ****\n";
+		return NULL;
+	}
+}
+
+template<class type>
+int Sequence<type> :: size()
+{
+	return slots.size();
+}
+
+template<class type>
+bool Sequence<type> :: contains(type item)
+{
+	for(size_t i = 0; i < slots.size(); ++i)
+	{
+		if(slots[i].item == item)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+template<class type>
+type Sequence<type> :: peek()
+{
+	return isEmpty() ? type() : slots.front().item;
+}
+
+template<class type>
+typename Sequence<type>::iterator Sequence<type> :: begin()
+{
+	return iterator(slots.begin());
+}
+
+template<class type>
+typename Sequence<type>::iterator Sequence<type> :: end()
+{
+	return iterator(slots.end());
+}
+
+template<class type>
+typename Sequence<type>::const_iterator Sequence<type> :: begin() const
+{
+	return const_iterator(slots.begin());
+}
+
+template<class type>
+typename Sequence<type>::const_iterator Sequence<type> :: end() const
+{
+	return const_iterator(slots.end());
+}
+
+
+#endif /* SEQUENCE_H_ */
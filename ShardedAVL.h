@@ -0,0 +1,470 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef SHARDEDAVL_H_
+#define SHARDEDAVL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "AVL.h"
+#include "AVLIter.h"
+using namespace std;
+
+
+enum ShardRouting
+{
+	RANGE_ROUTED,  // each shard holds one range of keys, scans stay cheap
+	HASH_ROUTED    // keys are scattered by hash, for point lookups only
+};
+
+
+/*******************************************************************************
+ * CLASS - ShardedAVL
+ * -----------------------------------------------------------------------------
+ * This class spreads its keys over a fixed number of independent AVL trees,
+ * each behind its own lock, so threads working on different shards never
+ * wait on each other. Every shard is a separate allocation padded out past a
+ * cache line, which keeps one shard's lock and counters off its neighbours'
+ * lines.
+ *
+ * Range routing gives each shard one slice of the key space. A shard that
+ * grows to more than twice the average size, and to more than twice the size
+ * of its lighter neighbour, hands that neighbour the keys on its side of the
+ * shard's root with AVL::splitOff and AVL::concat, and the boundary between
+ * them moves to the root's key. Load spreads from a hot spot one neighbour at
+ * a time. Hash routing needs no rebalancing, but ordered scans then merge all
+ * the shards. The keys to be given are counted first, a chunk at a time
+ * between inserts, so both locks are held only for the O(log n) move.
+ *
+ * Inserts never shed themselves, so no writer pays for a rebalance. An insert
+ * that finds its shard grown past the threshold only raises a flag, which
+ * unbalanced reports; rebalance does the work, called from a background
+ * thread or between batches of inserts.
+ *
+ * Routing reads the boundaries without a lock. A thread that routes a key by
+ * a boundary that is moving sees, once it holds the shard's lock, that the key
+ * is no longer in the shard's range and routes it again.
+ ******************************************************************************/
+template<class type>
+class ShardedAVL
+{
+public:
+
+	ShardedAVL(int shards = 0, ShardRouting routing = RANGE_ROUTED);
+		// POST: shards empty shards, one per core if 0; range routed shards
+		//       start with equal slices of the int range
+	~ShardedAVL();
+
+	bool insert(int id, type item);
+		// POST: item stored under id unless id was already present, safe
+		//       from any thread
+
+	bool find(int id, type& item);
+		// POST: item stored under id copied to item, false if there is none
+
+	long size();
+		// POST: number of keys, exact only while no insert is running
+
+	template<class Visit>
+	void forEach(Visit visit);
+		// POST: visit(id, item) called for every key in key order, with
+		//       every shard locked for the whole scan
+
+	bool unbalanced();
+		// POST: true if an insert has found its shard past the threshold
+		//       since the last rebalance
+
+	int rebalance();
+		// POST: shards more than twice the average size have given keys to
+		//       lighter neighbours, returns how many boundaries moved
+
+	int shards();
+
+private:
+
+	// the shards own their trees, so copies are not allowed
+	ShardedAVL(const ShardedAVL<type>&);
+	ShardedAVL<type>& operator = (const ShardedAVL<type>&);
+
+	// CALC - inserts into one shard between two looks at its size
+	static const long CHECK_EVERY = 4096;
+
+	// CALC - keys counted per hold of the lock while a shard sheds
+	static const long COUNT_CHUNK = 1024;
+
+	struct Shard
+	{
+		mutex        lock;
+		AVL<type>    tree;
+		atomic<long> count;  // CALC - keys in tree, written under lock
+		long         lower;  // CALC - lowest key the shard may hold
+		long         upper;  // CALC - one past the highest key
+		bool         busy;      // CALC - a shed into or out of it is under way
+		long         countLow;  // CALC - lowest key being counted
+		long         countHigh; // CALC - one past the highest key being counted
+		long         cursor;    // CALC - keys from countLow up to it are counted
+		long         behind;    // CALC - keys inserted below the cursor since
+		char         pad[64];
+	};
+
+	ShardRouting    routing;
+	int             count;   // CALC - number of shards
+	vector<Shard*>  shard;
+	atomic<int>    *bounds;  // CALC - lowest key of shard i + 1, range only
+	atomic<bool>    crowded; // CALC - a shard has passed the threshold
+
+	int  route(int id);
+	bool owns(Shard& s, int id);
+	bool shed(int heavy);
+	long countGiven(Shard& s);
+};
+
+
+template<class type>
+ShardedAVL<type> :: ShardedAVL(int shards, ShardRouting routing)
+{
+	this->routing = routing;
+	count  = shards > 0 ? shards : max(1, (int)thread::hardware_concurrency());
+	bounds = new atomic<int>[count];
+	crowded.store(false);
+
+	// INITIALIZE - equal slices of [INT_MIN, INT_MAX]
+	long span = ((long)INT_MAX - INT_MIN + 1) / count;
+	for (int i = 0; i < count; ++i)
+	{
+		Shard *s = new Shard;
+		s->count.store(0);
+		s->busy   = false;
+		s->cursor = s->countLow = s->countHigh = 0;
+		s->lower = i == 0 ? INT_MIN : (long)INT_MIN + span * i;
+		s->upper = i == count - 1 ? (long)INT_MAX + 1 : (long)INT_MIN + span * (i + 1);
+		bounds[i].store((int)min(s->upper, (long)INT_MAX));
+		shard.push_back(s);
+	}
+}
+
+template<class type>
+ShardedAVL<type> :: ~ShardedAVL()
+{
+	for (int i = 0; i < count; ++i)
+		delete shard[i];
+	delete [] bounds;
+}
+
+template<class type>
+int ShardedAVL<type> :: shards()
+{
+	return count;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - route / owns
+ * -----------------------------------------------------------------------------
+ * route picks a shard without locking; owns confirms the choice once the
+ * shard is locked.
+ ******************************************************************************/
+template<class type>
+int ShardedAVL<type> :: route(int id)
+{
+	if (routing == HASH_ROUTED)
+		return (int)(((uint64_t)(uint32_t)id * 0x9e3779b97f4a7c15ull >> 32) % count);
+
+	int low  = 0;
+	int high = count - 1;
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+		if (id < bounds[mid].load(memory_order_acquire))
+			high = mid;
+		else
+			low = mid + 1;
+	}
+	return low;
+}
+
+template<class type>
+bool ShardedAVL<type> :: owns(Shard& s, int id)
+{
+	return routing == HASH_ROUTED || (id >= s.lower && id < s.upper);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - insert
+ * -----------------------------------------------------------------------------
+ * Every CHECK_EVERY keys a range routed shard compares its size with the
+ * average and flags the tree for rebalance if it has grown past twice that.
+ ******************************************************************************/
+template<class type>
+bool ShardedAVL<type> :: insert(int id, type item)
+{
+	long keys;
+
+	while (true)
+	{
+		Shard &s = *shard[route(id)];
+		lock_guard<mutex> guard(s.lock);
+
+		if (!owns(s, id))
+			continue;
+		if (!s.tree.insert(id, item))
+			return false;
+
+		keys = s.count.load(memory_order_relaxed) + 1;
+		s.count.store(keys, memory_order_relaxed);
+		if (id >= s.countLow && id < s.cursor)
+			++s.behind;
+		break;
+	}
+
+	if (routing == RANGE_ROUTED && count > 1 && keys % CHECK_EVERY == 0 &&
+	    keys > 2 * size() / count)
+		crowded.store(true, memory_order_relaxed);
+	return true;
+}
+
+template<class type>
+bool ShardedAVL<type> :: find(int id, type& item)
+{
+	while (true)
+	{
+		Shard &s = *shard[route(id)];
+		lock_guard<mutex> guard(s.lock);
+
+		if (!owns(s, id))
+			continue;
+
+		type *found = s.tree.find(id);
+		if (found)
+			item = *found;
+		return found != NULL;
+	}
+}
+
+template<class type>
+long ShardedAVL<type> :: size()
+{
+	long total = 0;
+
+	for (int i = 0; i < count; ++i)
+		total += shard[i]->count.load(memory_order_relaxed);
+	return total;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - forEach
+ * -----------------------------------------------------------------------------
+ * Range routed shards hold consecutive slices, so they are walked one after
+ * another. Hash routed shards are merged: a small heap holds the next key of
+ * each shard and the smallest is visited and replaced, a k-way merge costing
+ * O(log shards) per key.
+ ******************************************************************************/
+template<class type>
+template<class Visit>
+void ShardedAVL<type> :: forEach(Visit visit)
+{
+	typedef pair<int, int> Head;  // next key of a shard, and the shard
+
+	for (int i = 0; i < count; ++i)
+		shard[i]->lock.lock();
+
+	if (routing == RANGE_ROUTED)
+	{
+		for (int i = 0; i < count; ++i)
+			for (AVLIter<type> it = shard[i]->tree.begin(); it != shard[i]->tree.end(); ++it)
+				visit(it.id(), *it);
+	}
+	else
+	{
+		vector<AVLIter<type> > next;
+		vector<Head> heap;
+
+		for (int i = 0; i < count; ++i)
+		{
+			next.push_back(shard[i]->tree.begin());
+			if (next[i] != shard[i]->tree.end())
+				heap.push_back(Head(next[i].id(), i));
+		}
+		make_heap(heap.begin(), heap.end(), greater<Head>());
+
+		while (!heap.empty())
+		{
+			pop_heap(heap.begin(), heap.end(), greater<Head>());
+			int i = heap.back().second;
+			heap.pop_back();
+
+			visit(next[i].id(), *next[i]);
+			if (++next[i] != shard[i]->tree.end())
+			{
+				heap.push_back(Head(next[i].id(), i));
+				push_heap(heap.begin(), heap.end(), greater<Head>());
+			}
+		}
+	}
+
+	for (int i = count - 1; i >= 0; --i)
+		shard[i]->lock.unlock();
+}
+
+
+/*******************************************************************************
+ * FUNCTION - unbalanced / rebalance
+ ******************************************************************************/
+template<class type>
+bool ShardedAVL<type> :: unbalanced()
+{
+	return crowded.load(memory_order_relaxed);
+}
+
+template<class type>
+int ShardedAVL<type> :: rebalance()
+{
+	int moved = 0;
+
+	if (routing == HASH_ROUTED)
+		return 0;
+	crowded.store(false, memory_order_relaxed);
+
+	// a hot spot may need several passes to spread out past its neighbours
+	for (int pass = 0; pass < count; ++pass)
+	{
+		int before = moved;
+		for (int i = 0; i < count; ++i)
+			if (shed(i))
+				++moved;
+		if (moved == before)
+			break;
+	}
+	return moved;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - shed
+ * -----------------------------------------------------------------------------
+ * Splits shard heavy at its root key and gives the side next to its lighter
+ * neighbour to that neighbour. The size test is made with both shards
+ * locked, lower index first, and the keys to give are then counted with
+ * countGiven under heavy's lock alone. Neither shard sheds again until the
+ * move is done, so the boundary between them holds still in the meantime.
+ * The move itself retakes both locks and costs one splitOff and one concat.
+ * -----------------------------------------------------------------------------
+ * return: true if a boundary moved
+ ******************************************************************************/
+template<class type>
+bool ShardedAVL<type> :: shed(int heavy)
+{
+	if (count == 1)
+		return false;
+
+	int light = heavy + 1;
+	if (heavy == count - 1 ||
+	    (heavy > 0 && shard[heavy - 1]->count.load() < shard[heavy + 1]->count.load()))
+		light = heavy - 1;
+
+	Shard &from = *shard[heavy];
+	Shard &to   = *shard[light];
+	int  key;
+
+	{
+		lock_guard<mutex> first(shard[min(heavy, light)]->lock);
+		lock_guard<mutex> second(shard[max(heavy, light)]->lock);
+
+		long keys = from.count.load();
+		if (keys <= 2 * size() / count || keys <= 2 * to.count.load() ||
+		    !from.tree.root || from.busy || to.busy)
+			return false;
+
+		key = from.tree.root->id;
+		from.busy      = true;
+		to.busy        = true;
+		from.countLow  = light > heavy ? key : from.lower;
+		from.countHigh = light > heavy ? from.upper : key;
+		from.cursor    = from.countLow;
+		from.behind    = 0;
+	}
+
+	long given = countGiven(from);
+
+	lock_guard<mutex> first(shard[min(heavy, light)]->lock);
+	lock_guard<mutex> second(shard[max(heavy, light)]->lock);
+	AVL<type> rest;
+
+	given += from.behind;
+	from.cursor = from.countLow;
+	from.busy   = false;
+	to.busy     = false;
+
+	from.tree.splitOff(key, rest);
+	if (light > heavy)
+	{
+		// GIVE - keys from the root up go to the next shard
+		to.tree.concat(rest);
+		from.upper = to.lower = key;
+		bounds[heavy].store(key, memory_order_release);
+	}
+	else
+	{
+		// GIVE - keys below the root go to the previous shard
+		to.tree.concat(from.tree);
+		from.tree.concat(rest);
+		from.lower = to.upper = key;
+		bounds[light].store(key, memory_order_release);
+	}
+
+	from.count.store(from.count.load() - given);
+	to.count.store(to.count.load() + given);
+	return given > 0;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - countGiven
+ * -----------------------------------------------------------------------------
+ * Counts the keys of s in [countLow, countHigh), taking s's lock for
+ * COUNT_CHUNK keys at a time so that inserts go on in between. Keys inserted
+ * behind the cursor are added to s.behind by insert, keys inserted ahead of
+ * it are met by the count, so the count plus behind is exact once the lock
+ * is next held.
+ * -----------------------------------------------------------------------------
+ * return: keys counted
+ ******************************************************************************/
+template<class type>
+long ShardedAVL<type> :: countGiven(Shard& s)
+{
+	long counted = 0;
+
+	while (true)
+	{
+		lock_guard<mutex> guard(s.lock);
+
+		if (s.cursor >= s.countHigh)
+			return counted;
+
+		AVLIter<type> it = s.tree.lowerBound((int)s.cursor);
+		long n = 0;
+
+		for (; n < COUNT_CHUNK && it != s.tree.end() && it.id() < s.countHigh; ++it)
+		{
+			s.cursor = (long)it.id() + 1;
+			++n;
+		}
+		if (n < COUNT_CHUNK)
+			s.cursor = s.countHigh;
+		counted += n;
+	}
+}
+
+
+#endif /* SHARDEDAVL_H_ */
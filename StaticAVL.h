@@ -0,0 +1,205 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef STATICAVL_H_
+#define STATICAVL_H_
+
+#include <climits>
+#include <cstddef>
+#include <stdexcept>
+using namespace std;
+
+
+/*******************************************************************************
+ * STRUCT - StaticPair / StaticSlot
+ ******************************************************************************/
+template<class type>
+struct StaticPair
+{
+	int  id;
+	type item;
+};
+
+template<class type>
+struct StaticSlot
+{
+	int  id;
+	bool used;   // CALC - false for the padding that completes the tree
+	type item;
+};
+
+
+/*******************************************************************************
+ * STRUCT - StaticSeq / MakeStaticSeq
+ * -----------------------------------------------------------------------------
+ * The indices 0 .. n - 1 as a parameter pack, which lets a constexpr
+ * constructor fill an array one element per index.
+ ******************************************************************************/
+template<size_t... I>
+struct StaticSeq {};
+
+template<size_t N, size_t... I>
+struct MakeStaticSeq : MakeStaticSeq<N - 1, N - 1, I...> {};
+
+template<size_t... I>
+struct MakeStaticSeq<0, I...>
+{
+	typedef StaticSeq<I...> type;
+};
+
+
+/*******************************************************************************
+ * FUNCTION - staticLevels
+ * -----------------------------------------------------------------------------
+ * return: levels of the smallest complete binary tree with n nodes or more
+ ******************************************************************************/
+constexpr int staticLevels(size_t n)
+{
+	return n == 0 ? 0 : 1 + staticLevels(n / 2);
+}
+
+
+/*******************************************************************************
+ * STRUCT - StaticDescent
+ * -----------------------------------------------------------------------------
+ * One level of the search per template instance, so a descent through LEVELS
+ * levels is that many compare and shift steps with no loop and no branch.
+ ******************************************************************************/
+template<int LEVELS>
+struct StaticDescent
+{
+	template<class type>
+	static constexpr size_t run(const StaticSlot<type> *slots, int id, size_t k)
+	{
+		return StaticDescent<LEVELS - 1>::run(slots, id, 2 * k + (slots[k - 1].id < id));
+	}
+};
+
+template<>
+struct StaticDescent<0>
+{
+	template<class type>
+	static constexpr size_t run(const StaticSlot<type> *, int, size_t k)
+	{
+		return k;
+	}
+};
+
+
+/*******************************************************************************
+ * CLASS - StaticAVL
+ * -----------------------------------------------------------------------------
+ * This class is a search tree over N keys that is built entirely by the
+ * compiler. A constexpr StaticAVL is laid out in read-only data, so it costs
+ * nothing at startup and never touches the heap.
+ *
+ * The keys are padded out to a complete tree of SLOTS = 2^LEVELS - 1 slots
+ * and stored in breadth first (Eytzinger) order: the children of slot k are
+ * slots 2k and 2k + 1, counting from 1. The tree is perfectly balanced, so
+ * every search takes exactly LEVELS steps. Each step picks the next slot with
+ * a comparison rather than a branch, and the steps are unrolled by
+ * StaticDescent. The last slot passed that was not below id is the lower
+ * bound, recovered from the final index by dropping its trailing one bits.
+ *
+ * find matches AVL::find: a pointer to the item stored under id, or NULL.
+ * The pairs must be given in strictly increasing key order; anything else
+ * fails to compile when the tree is built as a constant.
+ ******************************************************************************/
+template<class type, size_t N>
+class StaticAVL
+{
+public:
+
+	static_assert(N > 0, "a StaticAVL needs at least one key");
+
+	static constexpr int    LEVELS = staticLevels(N);
+	static constexpr size_t SLOTS  = ((size_t)1 << LEVELS) - 1;
+
+	constexpr StaticAVL(const StaticPair<type> (&pairs)[N])
+		: StaticAVL(checked(pairs), typename MakeStaticSeq<SLOTS>::type()) {}
+
+	constexpr const type* find(int id) const
+	{
+		return slotAt(StaticDescent<LEVELS>::run(slots, id, 1), id);
+	}
+		// POST: the item stored under id, NULL if there is none
+
+	constexpr size_t size() const
+	{
+		return N;
+	}
+
+private:
+
+	StaticSlot<type> slots[SLOTS];
+
+	template<size_t... I>
+	constexpr StaticAVL(const StaticPair<type> *pairs, StaticSeq<I...>)
+		: slots{ slotFor(pairs, rank(I + 1))... } {}
+
+	static constexpr const StaticPair<type>* checked(const StaticPair<type> *pairs)
+	{
+		return increasing(pairs, 1) ? pairs
+		     : throw logic_error("StaticAVL keys must be strictly increasing");
+	}
+
+	static constexpr bool increasing(const StaticPair<type> *pairs, size_t i)
+	{
+		return i >= N || (pairs[i - 1].id < pairs[i].id && increasing(pairs, i + 1));
+	}
+
+	static constexpr StaticSlot<type> slotFor(const StaticPair<type> *pairs, size_t r)
+	{
+		return r < N ? StaticSlot<type>{ pairs[r].id, true, pairs[r].item }
+		             : StaticSlot<type>{ INT_MAX, false, type() };
+	}
+
+	// CALC - slots under slot k, one level of it per call
+	static constexpr size_t subtreeSize(size_t k, size_t width = 1)
+	{
+		return k > SLOTS ? 0 : width + subtreeSize(2 * k, 2 * width);
+	}
+
+	// CALC - position of slot k in key order
+	static constexpr size_t rank(size_t k)
+	{
+		return k == 1     ? subtreeSize(2)
+		     : k % 2 == 0 ? rank(k / 2) - 1 - subtreeSize(2 * k + 1)
+		                  : rank(k / 2) + 1 + subtreeSize(2 * k);
+	}
+
+	constexpr const type* slotAt(size_t k, int id) const
+	{
+		return matches(k >> (__builtin_ctzll(~(unsigned long long)k) + 1), id);
+	}
+
+	constexpr const type* matches(size_t k, int id) const
+	{
+		return k && slots[k - 1].used && slots[k - 1].id == id ? &slots[k - 1].item : NULL;
+	}
+};
+
+template<class type, size_t N>
+constexpr int StaticAVL<type, N>::LEVELS;
+
+template<class type, size_t N>
+constexpr size_t StaticAVL<type, N>::SLOTS;
+
+
+/*******************************************************************************
+ * FUNCTION - makeStaticAVL
+ * -----------------------------------------------------------------------------
+ * Deduces N from the array, as in
+ *
+ *     constexpr StaticPair<int> codes[] = { {1, 10}, {4, 40}, {9, 90} };
+ *     constexpr StaticAVL<int, 3> table = makeStaticAVL(codes);
+ ******************************************************************************/
+template<class type, size_t N>
+constexpr StaticAVL<type, N> makeStaticAVL(const StaticPair<type> (&pairs)[N])
+{
+	return StaticAVL<type, N>(pairs);
+}
+
+
+#endif /* STATICAVL_H_ */
@@ -0,0 +1,192 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef TTLCACHE_H_
+#define TTLCACHE_H_
+
+#include <climits>
+#include <utility>
+
+#include "AVL.h"
+#include "AVLMultimap.h"
+using namespace std;
+
+
+/*******************************************************************************
+ * STRUCT - TTLEntry
+ ******************************************************************************/
+template<class type>
+struct TTLEntry
+{
+	type item;
+	int  expires;  // CALC - first tick at which the entry is gone
+};
+
+
+/*******************************************************************************
+ * CLASS - TTLCache
+ * -----------------------------------------------------------------------------
+ * This class is an AVL tree of items keyed by id, each of which may carry an
+ * expiry time. Times are ticks of whatever clock the caller keeps, seconds or
+ * milliseconds since start, passed in as now; an entry has expired once now
+ * reaches its expiry.
+ *
+ * Besides the entries, an AVLMultimap indexes ids by expiry time, so sweep
+ * finds everything that has expired by walking the front of the index and
+ * never scans the entries. The index holds exactly one pair per entry that
+ * can expire: putting an entry with a new time, or erasing it, takes its old
+ * pair out, so an entry touched on every request costs the index nothing
+ * extra. Between sweeps get reports expired entries as misses.
+ *
+ * The cache is not locked: a background tick that calls sweep must hold the
+ * same lock as the threads that use the cache.
+ ******************************************************************************/
+template<class type>
+class TTLCache
+{
+public:
+
+	static const int NEVER = INT_MAX;
+
+	TTLCache();
+
+	void put(int id, const type& item, int expires = NEVER);
+		// POST: item stored under id until tick expires, replacing any entry
+		//       already there
+
+	bool get(int id, int now, type& item);
+		// POST: item under id copied to item, false if there is none or it
+		//       has expired by now
+
+	bool erase(int id);
+		// POST: entry under id removed, false if there was none
+
+	long sweep(int now, long budget = LONG_MAX);
+		// POST: entries expired by now removed, earliest expiry first, at
+		//       most budget of them; returns how many
+
+	long size();
+		// POST: entries held, expired ones not yet swept included
+
+private:
+
+	// the cache owns its trees, so copies are not allowed
+	TTLCache(const TTLCache<type>&);
+	TTLCache<type>& operator = (const TTLCache<type>&);
+
+	AVL<TTLEntry<type> > entries;
+	AVLMultimap<int>     expiry;   // ids by expiry tick
+	long                 count;    // CALC - entries held
+};
+
+
+template<class type>
+TTLCache<type> :: TTLCache()
+{
+	count = 0;
+}
+
+/*******************************************************************************
+ * FUNCTION - put / erase
+ * -----------------------------------------------------------------------------
+ * An entry's pair in the index changes only when its expiry time does, and
+ * the old pair is removed before the new one goes in.
+ ******************************************************************************/
+template<class type>
+void TTLCache<type> :: put(int id, const type& item, int expires)
+{
+	pair<Node<TTLEntry<type> >*, bool> at = entries.findOrInsert(id);
+	TTLEntry<type> &entry = at.first->item;
+
+	if (at.second)
+		++count;
+	else if (entry.expires == expires)
+	{
+		entry.item = item;
+		return;
+	}
+	else if (entry.expires != NEVER)
+		expiry.erase(entry.expires, id);
+
+	entry.item    = item;
+	entry.expires = expires;
+	if (expires != NEVER)
+		expiry.insert(expires, id);
+}
+
+template<class type>
+bool TTLCache<type> :: get(int id, int now, type& item)
+{
+	TTLEntry<type> *entry = entries.find(id);
+
+	if (!entry || (entry->expires != NEVER && entry->expires <= now))
+		return false;
+	item = entry->item;
+	return true;
+}
+
+template<class type>
+bool TTLCache<type> :: erase(int id)
+{
+	TTLEntry<type> *entry = entries.find(id);
+
+	if (!entry)
+		return false;
+	if (entry->expires != NEVER)
+		expiry.erase(entry->expires, id);
+	entries.remove(id);
+	--count;
+	return true;
+}
+
+template<class type>
+long TTLCache<type> :: size()
+{
+	return count;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - sweep
+ * -----------------------------------------------------------------------------
+ * This function takes pairs off the front of the expiry index, earliest time
+ * first, while that time has been reached. The index holds no stale pairs, so
+ * every pair taken removes one entry and budget bounds the work exactly: k
+ * expired entries cost O(k log n). Each bucket is emptied from the back, which
+ * keeps every index erase O(log n), and a sweep may stop partway through one.
+ * -----------------------------------------------------------------------------
+ * return: number of entries removed
+ ******************************************************************************/
+template<class type>
+long TTLCache<type> :: sweep(int now, long budget)
+{
+	typedef typename AVLMultimap<int>::Bucket Bucket;
+
+	long removed = 0;
+
+	while (removed < budget)
+	{
+		AVLIter<Bucket> it = expiry.tree.begin();
+		if (it == expiry.tree.end() || it.id() > now)
+			break;
+
+		int     time   = it.id();
+		Bucket &bucket = *it;
+
+		// REMOVE - the bucket goes with its last pair, so it is not read after
+		for (long left = bucket.size(); left > 0 && removed < budget; --left)
+		{
+			int id = bucket[left - 1];
+			entries.remove(id);
+			expiry.erase(time, id);
+			++removed;
+		}
+	}
+
+	count -= removed;
+	return removed;
+}
+
+
+#endif /* TTLCACHE_H_ */
@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef TREEEXPORT_H_
+#define TREEEXPORT_H_
+
+#include <iostream>
+#include <cstring>
+
+#include "Node.h"
+
+
+/*******************************************************************************
+ * CLASS - TreeExport
+ * -----------------------------------------------------------------------------
+ * This class writes a binary tree, or the part of it under one key down to a
+ * given depth, as a Graphviz digraph or as nested JSON objects. Each node is
+ * written with its key and balance state.
+ *
+ * The walk climbs back up through parent pointers rather than keeping a stack,
+ * so it needs the same few words of memory for any tree. Output goes through a
+ * fixed buffer of BUFFER bytes that is handed to the stream whenever it fills,
+ * so a tree of millions of nodes costs a few hundred stream writes.
+ ******************************************************************************/
+template<class type>
+class TreeExport
+{
+public:
+
+	TreeExport(ostream& out);
+	~TreeExport();
+
+	void dot(Node<type> *root, int maxDepth = -1);
+		// POST: the tree under root, maxDepth levels of it if not negative,
+		//       is written as a Graphviz digraph
+
+	void json(Node<type> *root, int maxDepth = -1);
+		// POST: the same tree is written as one JSON object per node, with
+		//       "left" and "right" holding the children or null. A node whose
+		//       children were cut off by maxDepth is marked "truncated"
+
+	void flush();
+		// POST: everything buffered is handed to the stream
+
+	static Node<type>* subtree(Node<type> *root, int key);
+		// POST: the node holding key under root, NULL if there is none
+
+private:
+
+	enum Format { DOT, JSON };
+
+	static const int BUFFER = 1 << 16;
+
+	ostream &out;
+	int      used;           // CALC - bytes waiting in buffer
+	char     buffer[BUFFER];
+
+	void walk(Node<type> *top, int maxDepth, Format format);
+
+	void put(const char *text);
+	void put(char c);
+	void putKey(int key);
+	void putEdge(Node<type> *from, Node<type> *to);
+};
+
+
+template<class type>
+TreeExport<type> :: TreeExport(ostream& out) : out(out)
+{
+	used = 0;
+}
+
+template<class type>
+TreeExport<type> :: ~TreeExport()
+{
+	flush();
+}
+
+template<class type>
+void TreeExport<type> :: flush()
+{
+	out.write(buffer, used);
+	out.flush();
+	used = 0;
+}
+
+template<class type>
+Node<type>* TreeExport<type> :: subtree(Node<type> *root, int key)
+{
+	while (root && root->id != key)
+		root = key < root->id ? root->left : root->right;
+	return root;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - dot / json
+ ******************************************************************************/
+template<class type>
+void TreeExport<type> :: dot(Node<type> *root, int maxDepth)
+{
+	put("digraph AVL {\n");
+	put("\tnode [shape=circle, fontname=\"monospace\"];\n");
+	if (root && maxDepth != 0)
+		walk(root, maxDepth, DOT);
+	put("}\n");
+	flush();
+}
+
+template<class type>
+void TreeExport<type> :: json(Node<type> *root, int maxDepth)
+{
+	if (root && maxDepth != 0)
+		walk(root, maxDepth, JSON);
+	else
+		put("null");
+	put('\n');
+	flush();
+}
+
+
+/*******************************************************************************
+ * FUNCTION - walk
+ * -----------------------------------------------------------------------------
+ * A depth first walk that remembers only which way it last moved. Arriving at
+ * a node from its parent writes the node, from its left child moves on to the
+ * right child, and from its right child closes the node and climbs. Children
+ * below maxDepth are not entered, and a node that loses children that way is
+ * drawn dashed in DOT and marked as truncated in JSON.
+ ******************************************************************************/
+template<class type>
+void TreeExport<type> :: walk(Node<type> *top, int maxDepth, Format format)
+{
+	enum Arrival { FROM_PARENT, FROM_LEFT, FROM_RIGHT };
+
+	Node<type> *node  = top;
+	Arrival     from  = FROM_PARENT;
+	int         depth = 1;
+
+	while (true)
+	{
+		bool deeper = maxDepth < 0 || depth < maxDepth;
+
+		if (from == FROM_PARENT)
+		{
+			if (format == DOT)
+			{
+				bool cut = !deeper && (node->left || node->right);
+
+				put('\t');
+				putKey(node->id);
+				put(" [label=\"");
+				putKey(node->id);
+				put(' ');
+				put(node->state);
+				put(cut ? "\", style=dashed];\n" : "\"];\n");
+
+				if (node->left && deeper)
+					putEdge(node, node->left);
+				if (node->right && deeper)
+					putEdge(node, node->right);
+			}
+			else
+			{
+				put("{\"key\":");
+				putKey(node->id);
+				put(",\"state\":\"");
+				put(node->state);
+				put("\",\"left\":");
+			}
+
+			if (node->left && deeper)
+			{
+				node = node->left;
+				++depth;
+				continue;
+			}
+			if (format == JSON)
+				put("null");
+			from = FROM_LEFT;
+		}
+
+		if (from == FROM_LEFT)
+		{
+			if (format == JSON)
+				put(",\"right\":");
+
+			if (node->right && deeper)
+			{
+				node = node->right;
+				from = FROM_PARENT;
+				++depth;
+				continue;
+			}
+			if (format == JSON)
+				put("null");
+		}
+
+		// CLOSE - the node and both its subtrees are written
+		if (format == JSON)
+		{
+			if (!deeper && (node->left || node->right))
+				put(",\"truncated\":true");
+			put('}');
+		}
+
+		if (node == top)
+			break;
+
+		Node<type> *p_node = node->parent;
+		from = node == p_node->left ? FROM_LEFT : FROM_RIGHT;
+		node = p_node;
+		--depth;
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - put
+ ******************************************************************************/
+template<class type>
+void TreeExport<type> :: put(const char *text)
+{
+	int length = strlen(text);
+
+	if (used + length > BUFFER)
+	{
+		out.write(buffer, used);
+		used = 0;
+	}
+	memcpy(buffer + used, text, length);
+	used += length;
+}
+
+template<class type>
+void TreeExport<type> :: put(char c)
+{
+	if (used == BUFFER)
+	{
+		out.write(buffer, used);
+		used = 0;
+	}
+	buffer[used++] = c;
+}
+
+template<class type>
+void TreeExport<type> :: putKey(int key)
+{
+	char digits[12];
+	int  at   = sizeof(digits);
+	long rest = key < 0 ? -(long)key : key;
+
+	digits[--at] = '\0';
+	do
+	{
+		digits[--at] = '0' + rest % 10;
+		rest /= 10;
+	}
+	while (rest);
+
+	if (key < 0)
+		digits[--at] = '-';
+	put(digits + at);
+}
+
+template<class type>
+void TreeExport<type> :: putEdge(Node<type> *from, Node<type> *to)
+{
+	put('\t');
+	putKey(from->id);
+	put(" -> ");
+	putKey(to->id);
+	put(";\n");
+}
+
+
+#endif /* TREEEXPORT_H_ */
@@ -5,240 +5,256 @@
 #ifndef TREEPRINTER_H_
 #define TREEPRINTER_H_
 
+#include <algorithm>
+#include <climits>
 #include <iostream>
-#include <sstream>
 #include <string>
-#include <math.h>
+#include <vector>
 
 #include "Node.h"
-#include "List.h"
-#include "ListIter.h"
 
 
 /*******************************************************************************
  * CLASS - TreePrinter
  * -----------------------------------------------------------------------------
- * This class encapsulates methods to print a binary tree. The methods included
- * in this class help to correctly space and add empty nodes wherever needed.
- * The output is useful to see how a binary tree is being manipulated as well
- * as where things may have gone wrong.
+ * This class encapsulates methods to print a binary tree. Each level of the
+ * tree is one row, every node centred over the slot its subtree spans, with
+ * underscores running out to its children. The output is useful to see how a
+ * binary tree is being manipulated as well as where things may have gone
+ * wrong.
+ *
+ * A row is drawn into one reused buffer and written out whole, so printing
+ * costs time in proportion to the characters printed and, once the buffers
+ * have grown, allocates nothing. Levels below maxDepth, and levels whose row
+ * would be wider than maxWidth, are left out and counted in a closing line,
+ * which walks the whole tree once to find its real depth; a maxWidth of 0
+ * puts no limit on the width. Printing a node further down shows the tree
+ * beneath it.
  ******************************************************************************/
 template<class type>
 class TreePrinter
 {
 
 public:
+	TreePrinter(int maxDepth = 16, int maxWidth = 0);
+
 	void print(Node<type>*, ostream&);
 
 private:
-	int height;
-	int maxDigits;
-	int nodeLength;
-	Node<type> *root;
-	List<Node<type>*> leaves;
-	List<List<Node<type>*>*> levels;
+	int maxDepth;   // CALC - most levels printed
+	int maxWidth;   // CALC - widest row printed, in characters, 0 for any
+	int keyDigits;  // CALC - characters of the widest key
+	int cell;       // CALC - characters per node on the bottom row
+
+	string row;                // rows are drawn here
+	vector<Node<type>*> level; // slots of the row being drawn, NULL if empty
+	vector<Node<type>*> below; // slots of the next row
 
 	// PRINT helpers
-	int  getHeight(Node<type>*);
-	int  getMaxDigits(Node<type>*);
-	int  digits(int);
+	static int depthOf(Node<type>*, int);
+	static int digits(int);
+	void drawLabel(int, Node<type>*);
+};
 
-	void inOrder(Node<type>*, int);
-	void fillPrinterForEmptyNode(int);
 
-	List<string>* constructLevels();
-	void cleanLevels();
+template<class type>
+TreePrinter<type> :: TreePrinter(int maxDepth, int maxWidth)
+{
+	this->maxDepth = maxDepth < 1 ? 1 : maxDepth;
+	this->maxWidth = maxWidth;
+	keyDigits = 0;
+	cell      = 0;
+}
 
-	string pad(char, int);
-	string paddedInt(int);
-	string lvlString(int, int, int, List<Node<type>*>*);
-};
 
+/*******************************************************************************
+ * FUNCTION - print
+ * -----------------------------------------------------------------------------
+ * Level d of the printed tree has 2^d slots across a row of cell * 2^(shown-1)
+ * characters, so each row is filled in one sweep from the slots of the row
+ * above, and only the levels that are printed are ever visited.
+ ******************************************************************************/
 template<class type>
 void TreePrinter<type> :: print(Node<type> *root, ostream& out)
 {
-	cout << endl << endl
+	out << endl << endl
 		 << "~~~~~~~~~~~~~~~~~~~~~~~~" << endl
 		 << "TREE PRINTER!!" << endl
 		 << "~~~~~~~~~~~~~~~~~~~~~~~~" << endl;
 
-	height = getHeight(root);
-	maxDigits = getMaxDigits(root);
-	nodeLength = maxDigits + 2;
-
-	// INITIALIZE - empty tree levels in list form for printer
-	for (int i = 0; i < height; ++i)
-		levels.add(new List<Node<type> *>);
-
-	// TRAVERSE in order to gather tree node data
-	inOrder(root, 0);
-	List<string> *treeString = constructLevels();
-
-	// OUTPUT - print the tree level by level
-	for(int i = 0; i < treeString->size(); ++i)
-		out << treeString->get(i)->item << endl;
-
-	// CLEAN PRINTER
-	height = 0;
-	maxDigits = 0;
-	cleanLevels();
-}
-
-template<class type>
-void TreePrinter<type> :: inOrder(Node<type> *root, int level)
-{
-	if(root != NULL)
+	if (!root)
 	{
-		// recurse left
-		inOrder(root->left, level + 1);
-
-		// SET - root height and add to levels
-		Node<type> *printNode = new Node<type>(root->id, root->item);
-		printNode->height = level;
-		printNode->state  = root->state;
-		levels.get(level)->item->add(printNode);
-
-		if(root->left == NULL)
-			fillPrinterForEmptyNode(level);
-		if(root->right == NULL)
-			fillPrinterForEmptyNode(level);
-
-		// recurse right
-		inOrder(root->right, level + 1);
+		out << "(empty)" << endl;
+		return;
 	}
-}
 
-template<class type>
-void TreePrinter<type> :: fillPrinterForEmptyNode(int currentTreeLevel)
-{
-	for(int i = currentTreeLevel + 1; i < levels.size(); ++i)
+	// CALC - the widest key is the smallest or the largest
+	Node<type> *low  = root;
+	Node<type> *high = root;
+	while (low->left)
+		low = low->left;
+	while (high->right)
+		high = high->right;
+	keyDigits = max(digits(low->id), digits(high->id));
+	cell      = keyDigits + 3;
+
+	// CALC - levels printed, given the depth and width limits
+	int shown = depthOf(root, maxDepth);
+	while (shown > 1 && maxWidth > 0 && ((long)cell << (shown - 1)) > maxWidth)
+		--shown;
+
+	int  width  = cell << (shown - 1);
+	bool hidden = false;
+
+	level.assign(1, root);
+	for (int depth = 0; depth < shown; ++depth)
 	{
-		int filler = pow(2, (i - 1) - currentTreeLevel);
+		int  slot = width >> depth;
+		bool last = depth + 1 == shown;
+		row.assign(width, ' ');
+		below.clear();
 
-		for(int k = 0; k < filler; ++k)
+		for (size_t i = 0; i < level.size(); ++i)
 		{
-			Node<type> *fillNode = new Node<type>(-1, -1);
-			fillNode->state = '*';
-			levels.get(i)->item->add(fillNode);
+			Node<type> *node = level[i];
+			int start = i * slot;
+
+			if (last)
+			{
+				if (node && (node->left || node->right))
+					hidden = true;
+			}
+			else
+			{
+				below.push_back(node ? node->left : NULL);
+				below.push_back(node ? node->right : NULL);
+			}
+
+			if (!node)
+				continue;
+
+			// BRANCHES - from the centre of each child slot to the label
+			int labelStart = start + slot / 2 - (keyDigits + 2) / 2;
+			int labelEnd   = labelStart + keyDigits + 2;
+
+			if (!last && node->left)
+				row.replace(start + slot / 4, labelStart - start - slot / 4,
+				            labelStart - start - slot / 4, '_');
+			if (!last && node->right)
+				row.replace(labelEnd, start + 3 * slot / 4 - labelEnd + 1,
+				            start + 3 * slot / 4 - labelEnd + 1, '_');
+
+			drawLabel(labelStart, node);
 		}
-	}
-}
 
-template<class type>
-List<string>* TreePrinter<type> :: constructLevels()
-{
-	int between;
-	int prevBetween;
-	int powCount;
-	int first;
-	int branch;
-	List<string> *treeString = new List<string>;
-
-	// INITIALIZE
-	powCount    = 2;
-	first       = 0;
-	branch      = 0;
-	prevBetween = 3 * nodeLength;
-	between     = 3 * nodeLength;
-
-	// builds the tree from the base lvl up to the root
-	for(int i = levels.size() - 1; i >= 0; --i)
-	{
-		// build the tree level by level
-		treeString->push(lvlString(first, branch, prevBetween, levels.get(i)->item));
-
-		// calculate factors for spacing the row correctly
-		powCount++;
-		branch      = pow(2,(levels.size() - i)) * nodeLength;
-		first       = between - nodeLength - branch;
-		prevBetween = between;
-		between     = (pow(2,powCount) - 1) * nodeLength;
+		// OUTPUT - the row without its trailing blanks
+		size_t length = row.find_last_not_of(' ') + 1;
+		out.write(row.data(), length);
+		out << '\n';
+
+		level.swap(below);
 	}
 
-	return treeString;
+	if (hidden)
+		out << "... " << depthOf(root, INT_MAX) - shown << " more level(s) not shown" << '\n';
+	out.flush();
 }
 
+
+/*******************************************************************************
+ * FUNCTION - drawLabel
+ * -----------------------------------------------------------------------------
+ * Writes the node's key, zero padded to keyDigits, then a blank and its state
+ * into row at column.
+ ******************************************************************************/
 template<class type>
-string TreePrinter<type> :: lvlString(int first, int branch, int between, List<Node<type> *> *level)
+void TreePrinter<type> :: drawLabel(int column, Node<type> *node)
 {
-	ostringstream buffer;
-	buffer << pad(' ', first);
+	long key   = node->id;
+	int  first = column;
+	int  end   = column + keyDigits;
 
-	for(int i = 0; i < level->size(); ++i)
+	if (key < 0)
 	{
-		buffer << pad('_', branch);
-		buffer << paddedInt(level->get(i)->item->id);
-		buffer << ' ' << level->get(i)->item->state;
-		buffer << pad('_', branch);
-		buffer << pad(' ', between);
+		row[first++] = '-';
+		key = -key;
 	}
 
-	return buffer.str();
-}
-
-template<class type>
-string TreePrinter<type> :: paddedInt(int n)
-{
-	int l = maxDigits - digits(n);
-	ostringstream buffer;
-
-	for(int i = 0; i < l; ++i)
-		buffer << 0;
+	for (int at = end - 1; at >= first; --at)
+	{
+		row[at] = '0' + key % 10;
+		key /= 10;
+	}
 
-	buffer << n;
-	return buffer.str();
+	row[end]     = ' ';
+	row[end + 1] = node->state;
 }
 
-template<class type>
-string TreePrinter<type> :: pad(char c, int length)
-{
-	ostringstream s;
-
-	for(int i = 0; i < length; ++i)
-		s << c;
-
-	return s.str();
-}
 
+/*******************************************************************************
+ * FUNCTION - depthOf
+ * -----------------------------------------------------------------------------
+ * Walks the subtree under node, down to limit levels, climbing back through
+ * parent pointers like AVL::stats, so it needs no stack and does not trust
+ * the balancing states of a tree that may be broken.
+ * -----------------------------------------------------------------------------
+ * return: number of levels under and including node, at most limit
+ ******************************************************************************/
 template<class type>
-void TreePrinter<type> :: cleanLevels()
+int TreePrinter<type> :: depthOf(Node<type> *top, int limit)
 {
-	for(int i = 0; i < levels.size(); ++i)
-		(levels.get(i)->item)->~List();
-	levels.~List();
-}
+	Node<type> *node    = top;
+	Node<type> *prev    = top->parent;
+	int         depth   = 0;
+	int         deepest = 0;
 
+	while (true)
+	{
+		// ENTER - arrived from the parent, go on down unless at the limit
+		if (prev == node->parent)
+		{
+			deepest = max(deepest, ++depth);
+			prev = node;
+			if (depth < limit && node->left)
+			{
+				node = node->left;
+				continue;
+			}
+			if (depth < limit && node->right)
+			{
+				node = node->right;
+				continue;
+			}
+		}
+		// TURN - back from the left subtree, walk the right one
+		else if (prev == node->left && node->right)
+		{
+			prev = node;
+			node = node->right;
+			continue;
+		}
 
-template<class type>
-int TreePrinter<type> :: digits(int n)
-{
-	if(n > 0)
-		return log10(n) + 1;
-	else if(n < 0)
-		return log10(fabs(n)) + 2;
-	else
-		return 1;
+		// CLIMB - both subtrees are done
+		if (node == top)
+			return deepest;
+		--depth;
+		prev = node;
+		node = node->parent;
+	}
 }
 
 template<class type>
-int TreePrinter<type> :: getHeight(Node<type> *node)
+int TreePrinter<type> :: digits(int n)
 {
-	if (node)
-		return max(getHeight(node->left), getHeight(node->right)) + 1;
-	else
-		return 0;
-}
+	long magnitude = n < 0 ? -(long)n : n;
+	int  count     = n < 0 ? 2 : 1;
 
-template<class type>
-int TreePrinter<type> :: getMaxDigits(Node<type> *node)
-{
-	if (node)
+	while (magnitude >= 10)
 	{
-		int childMaxDigits = max(getMaxDigits(node->left), getMaxDigits(node->right));
-		return max(childMaxDigits, digits((int)(node->id)));
+		magnitude /= 10;
+		++count;
 	}
-	else
-		return 0;
+	return count;
 }
 
 
@@ -0,0 +1,374 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ ******************************************************************************/
+#ifndef WORKLOAD_H_
+#define WORKLOAD_H_
+
+#include <stdint.h>
+#include <math.h>
+
+
+/*******************************************************************************
+ * CLASS - Rng
+ * -----------------------------------------------------------------------------
+ * This class is the xoshiro256** generator seeded through splitmix64. It is a
+ * few cycles per draw, passes the usual statistical batteries and, unlike
+ * rand(), gives the same stream for the same seed on every platform.
+ ******************************************************************************/
+class Rng
+{
+public:
+
+	Rng(uint64_t seed = 0);
+
+	uint64_t next();
+		// POST: next 64 random bits
+
+	uint64_t below(uint64_t bound);
+		// POST: uniform value in [0, bound) without modulo bias
+
+	double unit();
+		// POST: uniform value in [0, 1)
+
+private:
+	uint64_t s[4];
+
+	static uint64_t rotl(uint64_t x, int k);
+};
+
+
+inline Rng :: Rng(uint64_t seed)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		s[i] = z ^ (z >> 31);
+	}
+}
+
+inline uint64_t Rng :: rotl(uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+inline uint64_t Rng :: next()
+{
+	uint64_t result = rotl(s[1] * 5, 7) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	return result;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - below
+ * -----------------------------------------------------------------------------
+ * Lemire's multiply-shift method: the high half of a 32 by 32 bit product
+ * maps a draw into [0, bound), and the rare draws that would favour some
+ * values are rejected. Bounds past 2^32 fall back to masked rejection.
+ ******************************************************************************/
+inline uint64_t Rng :: below(uint64_t bound)
+{
+	if (bound <= 0xffffffffull)
+	{
+		uint32_t range = (uint32_t)bound;
+		uint64_t m = (next() >> 32) * range;
+		uint32_t low = (uint32_t)m;
+
+		if (low < range)
+		{
+			uint32_t floor = (uint32_t)(-range) % range;
+			while (low < floor)
+			{
+				m   = (next() >> 32) * range;
+				low = (uint32_t)m;
+			}
+		}
+		return m >> 32;
+	}
+
+	uint64_t mask = ~0ull >> __builtin_clzll(bound - 1);
+	uint64_t x;
+	do
+		x = next() & mask;
+	while (x >= bound);
+	return x;
+}
+
+inline double Rng :: unit()
+{
+	return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - shuffle
+ * -----------------------------------------------------------------------------
+ * Fisher-Yates shuffle. Every permutation of list is equally likely.
+ ******************************************************************************/
+inline void shuffle(int list[], long length, Rng &rng)
+{
+	for (long i = length - 1; i > 0; --i)
+	{
+		long j = rng.below(i + 1);
+		int temp = list[i];
+		list[i] = list[j];
+		list[j] = temp;
+	}
+}
+
+
+/*******************************************************************************
+ * ENUM WorkloadKind
+ ******************************************************************************/
+enum WorkloadKind
+{
+	UNIFORM,     // independent draws from [0, range), repeats possible
+	SHUFFLED,    // each of 0..count-1 once, in random order
+	SORTED,      // 0..count-1 ascending
+	REVERSE,     // count-1..0 descending
+	ZIPFIAN,     // skewed draws, a few hot keys take most of the stream
+	CLUSTERED,   // ascending runs starting at random bases
+	ADVERSARIAL, // ascending blocks of three inserted high key first, which
+	             // makes every AVL insert rebalance, two in three of them
+	             // with a double rotation
+	WORKLOAD_COUNT
+};
+
+const char * const WORKLOAD_NAMES[WORKLOAD_COUNT] = {
+	"uniform", "shuffled", "sorted", "reverse", "zipfian", "clustered", "adversarial"
+};
+
+
+/*******************************************************************************
+ * CLASS - Workload
+ * -----------------------------------------------------------------------------
+ * This class streams count keys of one kind. Keys are produced on demand, one
+ * at a time or in caller-sized batches, so a run of 10^8 keys needs no array
+ * of its own. The stream depends only on kind, count and seed; rewind starts
+ * the identical stream again, which lets a benchmark replay its inserts as
+ * lookups without keeping them.
+ ******************************************************************************/
+class Workload
+{
+public:
+
+	Workload(WorkloadKind kind, long count, uint64_t seed, long range = 0x7fffffff);
+
+	bool next(int &key);
+		// POST: next key of the stream, false once count keys are out
+
+	int fill(int *batch, int max);
+		// POST: up to max keys written to batch, returns how many
+
+	void rewind();
+		// POST: the stream starts over from its first key
+
+	long size();
+		// POST: number of keys in the stream
+
+private:
+
+	WorkloadKind kind;
+	long     count;    // CALC - keys in the stream
+	long     range;    // CALC - upper bound of uniform keys
+	uint64_t seed;
+	long     index;    // CALC - keys produced so far
+	Rng      rng;
+
+	// SHUFFLED - keyed Feistel permutation of [0, 2^(2 * halfBits))
+	int      halfBits;
+	uint32_t roundKeys[4];
+
+	// ZIPFIAN
+	double   theta, alpha, zetan, zeta2, eta;
+
+	// CLUSTERED
+	int      runBase;
+
+	static const int RUN = 1000;
+
+	uint64_t permute(uint64_t x);
+	static double zeta(long n, double theta);
+};
+
+
+inline Workload :: Workload(WorkloadKind kind, long count, uint64_t seed, long range)
+{
+	this->kind  = kind;
+	this->count = count;
+	this->range = range;
+	this->seed  = seed;
+
+	// the smallest even number of bits whose domain covers count
+	halfBits = 1;
+	while ((1ull << (2 * halfBits)) < (uint64_t)count)
+		++halfBits;
+
+	theta = 0.99;
+	if (kind == ZIPFIAN)
+	{
+		zetan = zeta(count, theta);
+		zeta2 = zeta(2, theta);
+		alpha = 1.0 / (1.0 - theta);
+		eta   = (1.0 - pow(2.0 / count, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+	}
+
+	rewind();
+}
+
+inline void Workload :: rewind()
+{
+	index   = 0;
+	runBase = 0;
+	rng     = Rng(seed);
+
+	for (int i = 0; i < 4; ++i)
+		roundKeys[i] = (uint32_t)rng.next();
+}
+
+inline long Workload :: size()
+{
+	return count;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - zeta
+ * -----------------------------------------------------------------------------
+ * The generalised harmonic number sum 1/i^theta for i = 1..n. Terms past the
+ * first million are replaced by their integral, which is accurate to well
+ * under a part per million and keeps 10^8 key streams quick to set up.
+ ******************************************************************************/
+inline double Workload :: zeta(long n, double theta)
+{
+	const long EXACT = 1000000;
+	double sum = 0;
+	long   m   = n < EXACT ? n : EXACT;
+
+	for (long i = 1; i <= m; ++i)
+		sum += 1.0 / pow((double)i, theta);
+
+	if (n > m)
+		sum += (pow((double)n + 0.5, 1.0 - theta) - pow((double)m + 0.5, 1.0 - theta))
+		     / (1.0 - theta);
+	return sum;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - permute
+ * -----------------------------------------------------------------------------
+ * A four round Feistel network is a bijection on its domain, so feeding it
+ * 0, 1, 2, ... and skipping outputs of count or more (cycle walking) yields
+ * every key below count exactly once. The domain is under four times count,
+ * so a walk takes fewer than four rounds on average.
+ ******************************************************************************/
+inline uint64_t Workload :: permute(uint64_t x)
+{
+	uint32_t mask = (1u << halfBits) - 1;
+
+	do
+	{
+		uint32_t left  = (uint32_t)(x >> halfBits) & mask;
+		uint32_t right = (uint32_t)x & mask;
+
+		for (int r = 0; r < 4; ++r)
+		{
+			uint32_t f = (right ^ roundKeys[r]) * 0x9e3779b1u;
+			f ^= f >> 15;
+			uint32_t next = left ^ (f & mask);
+			left  = right;
+			right = next;
+		}
+		x = ((uint64_t)left << halfBits) | right;
+	}
+	while (x >= (uint64_t)count);
+
+	return x;
+}
+
+
+/*******************************************************************************
+ * FUNCTION - next
+ ******************************************************************************/
+inline bool Workload :: next(int &key)
+{
+	if (index >= count)
+		return false;
+
+	long i = index++;
+	switch (kind)
+	{
+	case UNIFORM:
+		key = (int)rng.below(range);
+		break;
+
+	case SHUFFLED:
+		key = (int)permute(i);
+		break;
+
+	case SORTED:
+		key = (int)i;
+		break;
+
+	case REVERSE:
+		key = (int)(count - 1 - i);
+		break;
+
+	case ZIPFIAN:
+	{
+		// Gray et al. "Quickly generating billion-record synthetic databases"
+		double u  = rng.unit();
+		double uz = u * zetan;
+		long   rank;
+
+		if (uz < 1.0)
+			rank = 0;
+		else if (uz < zeta2)
+			rank = 1;
+		else
+			rank = (long)(count * pow(eta * u - eta + 1.0, alpha));
+
+		// SCATTER - so the hot keys are not also the smallest keys
+		key = (int)(((uint32_t)rank * 2654435761u) & 0x7fffffff);
+		break;
+	}
+
+	case CLUSTERED:
+		if (i % RUN == 0)
+			runBase = (int)rng.below(0x40000000);
+		key = runBase + (int)(i % RUN);
+		break;
+
+	case ADVERSARIAL:
+		key = (int)(i - i % 3 + 2 - i % 3);
+		break;
+
+	default:
+		key = 0;
+		break;
+	}
+	return true;
+}
+
+inline int Workload :: fill(int *batch, int max)
+{
+	int n = 0;
+
+	while (n < max && next(batch[n]))
+		++n;
+	return n;
+}
+
+
+#endif /* WORKLOAD_H_ */
@@ -0,0 +1,995 @@
+/*******************************************************************************
+ * PROGRAMMER : ERIC OLAVESON
+ * DATE       : 10/19/2026
+ * -----------------------------------------------------------------------------
+ * BUILD : g++ -O2 -std=c++11 -pthread benchmark.cpp -o benchmark
+ *         add -DAVL_INSTRUMENT for rotation counts and the counters suite;
+ *         the timings of that build include the counters' own cost
+ * USAGE : benchmark [suite] [max keys]
+ *         suite is one of all, core, bptree, counters, list, ingest, build,
+ *         setops, traverse, sharded, packed (default core)
+ *         max keys defaults to 10^6, sizes run from 10^3 up by powers of 10
+ ******************************************************************************/
+#include "AVL.h"
+#include "BPTree.h"
+#include "ConcurrentQueue.h"
+#include "List.h"
+#include "PackedKeys.h"
+#include "ShardedAVL.h"
+#include "Workload.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+
+/*******************************************************************************
+ * MEMORY ACCOUNTING
+ * -----------------------------------------------------------------------------
+ * Every container allocates through the global operator new, so replacing it
+ * lets us count live heap bytes. With glibc the usable size of each block plus
+ * its chunk header is charged, which includes the allocator overhead a node
+ * really costs. Elsewhere only the requested size is charged. Both are kept
+ * out of line so the compiler does not pair an inlined malloc with delete.
+ * Several suites allocate from many threads at once, so the count is atomic;
+ * relaxed is enough for a total that is only read between runs.
+ ******************************************************************************/
+static atomic<long> liveBytes(0);
+
+__attribute__((noinline))
+void* operator new(size_t size)
+{
+	void *p = malloc(size ? size : 1);
+	if (!p)
+		throw bad_alloc();
+#ifdef __GLIBC__
+	liveBytes.fetch_add(malloc_usable_size(p) + sizeof(size_t), memory_order_relaxed);
+#else
+	liveBytes.fetch_add(size, memory_order_relaxed);
+#endif
+	return p;
+}
+
+__attribute__((noinline))
+void operator delete(void *p) noexcept
+{
+#ifdef __GLIBC__
+	if (p)
+		liveBytes.fetch_sub(malloc_usable_size(p) + sizeof(size_t), memory_order_relaxed);
+#endif
+	free(p);
+}
+
+__attribute__((noinline))
+void operator delete(void *p, size_t) noexcept
+{
+	operator delete(p);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - elapsedNs
+ * -----------------------------------------------------------------------------
+ * return: nanoseconds since the given start time
+ ******************************************************************************/
+typedef chrono::steady_clock Clock;
+double elapsedNs(Clock::time_point start)
+{
+	return chrono::duration<double, nano>(Clock::now() - start).count();
+}
+
+
+/*******************************************************************************
+ * CONTAINER ADAPTERS
+ * -----------------------------------------------------------------------------
+ * put / has / walk give the trees and the std baselines one interface for the
+ * suites. rotationsOf returns -1 for containers that do not report rotations,
+ * the AVL reports the rotations made so far by all trees when the build
+ * counts them.
+ ******************************************************************************/
+bool put(AVL<int> &t, int k)          { return t.insert(k, k); }
+bool put(BPTree<int> &t, int k)       { return t.insert(k, k); }
+bool put(map<int, int> &t, int k)     { return t.insert(make_pair(k, k)).second; }
+bool put(set<int> &t, int k)          { return t.insert(k).second; }
+
+bool has(AVL<int> &t, int k)          { return t.find(k) != NULL; }
+bool has(BPTree<int> &t, int k)       { return t.find(k) != NULL; }
+bool has(map<int, int> &t, int k)     { return t.find(k) != t.end(); }
+bool has(set<int> &t, int k)          { return t.find(k) != t.end(); }
+
+long walk(AVL<int> &t)      { long s = 0; for (int x : t) s += x; return s; }
+long walk(BPTree<int> &t)   { long s = 0; for (int x : t) s += x; return s; }
+long walk(map<int, int> &t) { long s = 0; for (auto &x : t) s += x.second; return s; }
+long walk(set<int> &t)      { long s = 0; for (int x : t) s += x; return s; }
+
+template<class Tree>
+long rotationsOf(Tree &)    { return -1; }
+long rotationsOf(AVL<int> &)
+{
+#ifdef AVL_INSTRUMENT
+	AVLCounters::Snapshot total = AVLCounters::read();
+	return total.counters[BALANCE00] + total.counters[BALANCE01]
+	     + total.counters[BALANCE10] + total.counters[BALANCE11];
+#else
+	return -1;
+#endif
+}
+
+// erase is only timed on containers that support removal
+template<class Tree>
+bool canErase(Tree &)                  { return false; }
+bool canErase(AVL<int> &)              { return true; }
+bool canErase(map<int, int> &)         { return true; }
+bool canErase(set<int> &)              { return true; }
+
+template<class Tree>
+void drop(Tree &, int)                 {}
+void drop(AVL<int> &t, int k)          { t.remove(k); }
+void drop(map<int, int> &t, int k)     { t.erase(k); }
+void drop(set<int> &t, int k)          { t.erase(k); }
+
+
+/*******************************************************************************
+ * STRUCT Result
+ * -----------------------------------------------------------------------------
+ * One measured operation: throughput over the full pass plus latency
+ * percentiles from a separately timed sample of individual operations.
+ ******************************************************************************/
+struct Result
+{
+	double mops; // CALC - million operations per second
+	double p50;  // CALC - median latency in ns
+	double p99;  // CALC - 99th percentile latency in ns
+};
+
+void percentiles(vector<float> &samples, Result &r)
+{
+	if (samples.empty())
+	{
+		r.p50 = r.p99 = 0;
+		return;
+	}
+	size_t i50 = samples.size() / 2;
+	size_t i99 = samples.size() * 99 / 100;
+	nth_element(samples.begin(), samples.begin() + i50, samples.end());
+	r.p50 = samples[i50];
+	nth_element(samples.begin(), samples.begin() + i99, samples.end());
+	r.p99 = samples[i99];
+}
+
+// latency samples per operation, spread evenly over the pass
+const int SAMPLES = 100000;
+
+void printRow(const char *tree, const char *op, int n, const Result &r,
+              double rotPerOp, double bytesPerKey)
+{
+	printf("%-8s %-7s %10d %9.2f %8.0f %8.0f", tree, op, n, r.mops, r.p50, r.p99);
+	if (rotPerOp >= 0)
+		printf(" %8.3f", rotPerOp);
+	else
+		printf(" %8s", "-");
+	if (bytesPerKey >= 0)
+		printf(" %8.1f\n", bytesPerKey);
+	else
+		printf(" %8s\n", "");
+}
+
+
+/*******************************************************************************
+ * FUNCTION - benchCore
+ * -----------------------------------------------------------------------------
+ * This function measures insert, lookup, iteration and erase on one container
+ * for one workload. Keys stream from the workload in batches, and only the
+ * operations on each batch are timed. Inserts are timed on one tree for
+ * throughput and replayed on a second tree with every stride-th operation
+ * timed on its own, so the clock reads never slow down the throughput pass.
+ * Erases are timed the same way, the replay tree rebuilt untimed first.
+ * Lookups alternate between replayed keys and uniform draws that mostly miss.
+ ******************************************************************************/
+template<class Tree>
+void benchCore(const char *name, WorkloadKind kind, long n)
+{
+	const int BATCH = 4096;
+	int    batch[BATCH];
+	int    misses[BATCH];
+	int    got;
+	int    stride = max(1L, n / SAMPLES);
+	long   sink   = 0;
+	long   done;
+	double ns;
+	Result r;
+	Workload keys(kind, n, 42);
+	Workload probes(UNIFORM, n, 7);
+	vector<float> samples;
+	samples.reserve(n / stride + 1);
+
+	// INSERT
+	long   before = liveBytes;
+	Tree  *tree   = new Tree;
+	long   rotations = rotationsOf(*tree);
+	ns = 0;
+	while ((got = keys.fill(batch, BATCH)))
+	{
+		Clock::time_point start = Clock::now();
+		for (int i = 0; i < got; ++i)
+			sink += put(*tree, batch[i]);
+		ns += elapsedNs(start);
+	}
+	r.mops = n / ns * 1e3;
+	double bytesPerKey = (double)(liveBytes - before - sizeof(Tree)) / max(1L, sink);
+	if (rotations >= 0)
+		rotations = rotationsOf(*tree) - rotations;
+
+	{
+		Tree replay;
+		keys.rewind();
+		for (done = 0; (got = keys.fill(batch, BATCH)); done += got)
+			for (int i = 0; i < got; ++i)
+			{
+				if ((done + i) % stride)
+					put(replay, batch[i]);
+				else
+				{
+					Clock::time_point t = Clock::now();
+					put(replay, batch[i]);
+					samples.push_back(elapsedNs(t));
+				}
+			}
+	}
+	percentiles(samples, r);
+	printRow(name, "insert", n, r, rotations < 0 ? -1 : (double)rotations / n, bytesPerKey);
+
+	// LOOKUP
+	samples.clear();
+	keys.rewind();
+	ns = 0;
+	for (done = 0; (got = keys.fill(batch, BATCH)); done += got)
+	{
+		probes.fill(misses, got);
+		for (int i = 1; i < got; i += 2)
+			batch[i] = misses[i];
+
+		Clock::time_point start = Clock::now();
+		for (int i = 0; i < got; ++i)
+			sink += has(*tree, batch[i]);
+		ns += elapsedNs(start);
+
+		for (int i = (stride - done % stride) % stride; i < got; i += stride)
+		{
+			Clock::time_point t = Clock::now();
+			sink += has(*tree, batch[i]);
+			samples.push_back(elapsedNs(t));
+		}
+	}
+	r.mops = n / ns * 1e3;
+	percentiles(samples, r);
+	printRow(name, "lookup", n, r, -1, -1);
+
+	// ITERATE - latency is per key over a whole pass
+	Clock::time_point start = Clock::now();
+	sink += walk(*tree);
+	ns = elapsedNs(start);
+	r.mops = n / ns * 1e3;
+	r.p50 = r.p99 = ns / n;
+	printRow(name, "iterate", n, r, -1, -1);
+
+	// ERASE - timed like insert, then sampled on a rebuilt replay tree
+	if (canErase(*tree))
+	{
+		samples.clear();
+		keys.rewind();
+		ns = 0;
+		while ((got = keys.fill(batch, BATCH)))
+		{
+			Clock::time_point start = Clock::now();
+			for (int i = 0; i < got; ++i)
+				drop(*tree, batch[i]);
+			ns += elapsedNs(start);
+		}
+		r.mops = n / ns * 1e3;
+
+		Tree replay;
+		keys.rewind();
+		while ((got = keys.fill(batch, BATCH)))
+			for (int i = 0; i < got; ++i)
+				put(replay, batch[i]);
+
+		keys.rewind();
+		for (done = 0; (got = keys.fill(batch, BATCH)); done += got)
+			for (int i = 0; i < got; ++i)
+			{
+				if ((done + i) % stride)
+					drop(replay, batch[i]);
+				else
+				{
+					Clock::time_point t = Clock::now();
+					drop(replay, batch[i]);
+					samples.push_back(elapsedNs(t));
+				}
+			}
+		percentiles(samples, r);
+		printRow(name, "erase", n, r, -1, -1);
+	}
+
+	delete tree;
+	if (sink == 42)
+		printf(" ");
+}
+
+
+/*******************************************************************************
+ * SUITE - core
+ * -----------------------------------------------------------------------------
+ * Runs benchCore for the AVL tree and the std::map / std::set baselines over
+ * every workload and size.
+ ******************************************************************************/
+void suiteCore(long maxSize)
+{
+	for (int k = 0; k < WORKLOAD_COUNT; ++k)
+	{
+		printf("\n== %s ==\n", WORKLOAD_NAMES[k]);
+		printf("%-8s %-7s %10s %9s %8s %8s %8s %8s\n",
+		       "tree", "op", "keys", "Mops/s", "p50 ns", "p99 ns", "rot/op", "B/key");
+
+		for (long n = 1000; n <= maxSize; n *= 10)
+		{
+			benchCore<AVL<int> >("avl", (WorkloadKind)k, n);
+			benchCore<map<int, int> >("map", (WorkloadKind)k, n);
+			benchCore<set<int> >("set", (WorkloadKind)k, n);
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - benchTree
+ * -----------------------------------------------------------------------------
+ * This function times inserts, point lookups and range scans of scanLength
+ * keys on any tree offering the AVL interface, and prints one row per
+ * operation in nanoseconds per key. Keys are a shuffled permutation.
+ ******************************************************************************/
+template<class Tree>
+void benchTree(const char *name, long n, int scanLength)
+{
+	Tree tree;
+	Workload keys(SHUFFLED, n, 42);
+	long checksum = 0;
+	int  key;
+
+	Clock::time_point start = Clock::now();
+	while (keys.next(key))
+		tree.insert(key, key);
+	double insertNs = elapsedNs(start) / n;
+
+	keys.rewind();
+	start = Clock::now();
+	while (keys.next(key))
+		checksum += *tree.find(key);
+	double findNs = elapsedNs(start) / n;
+
+	long scans = max(1L, n / scanLength);
+	keys.rewind();
+	start = Clock::now();
+	for (long i = 0; i < scans && keys.next(key); ++i)
+	{
+		int k = 0;
+		for (auto it = tree.lowerBound(key); it != tree.end() && k < scanLength; ++it, ++k)
+			checksum += *it;
+	}
+	double scanNs = elapsedNs(start) / ((double)scans * scanLength);
+
+	printf("%-8s %10ld %12.1f %12.1f %12.2f   (checksum %ld)\n",
+	       name, n, insertNs, findNs, scanNs, checksum);
+}
+
+
+/*******************************************************************************
+ * SUITE - bptree
+ * -----------------------------------------------------------------------------
+ * Compares the binary AVL tree with the fat node BPTree on shuffled keys.
+ ******************************************************************************/
+void suiteBPTree(long maxSize)
+{
+	const int SCAN = 100;
+
+	printf("\n%-8s %10s %12s %12s %12s\n",
+	       "tree", "keys", "insert ns", "find ns", "scan ns/key");
+
+	for (long n = 1000; n <= maxSize; n *= 10)
+	{
+		benchTree<AVL<int> >("avl", n, SCAN);
+		benchTree<BPTree<int> >("bptree", n, SCAN);
+	}
+}
+
+
+/*******************************************************************************
+ * SUITE - counters
+ * -----------------------------------------------------------------------------
+ * Inserts shuffled keys into one AVL tree and writes the instrumentation
+ * counters as JSON, one object per size. Only an AVL_INSTRUMENT build has the
+ * counters.
+ ******************************************************************************/
+void suiteCounters(long maxSize)
+{
+#ifndef AVL_INSTRUMENT
+	(void)maxSize;
+	printf("counters: rebuild with -DAVL_INSTRUMENT\n");
+#else
+	for (long n = 1000; n <= maxSize; n *= 10)
+	{
+		Workload keys(SHUFFLED, n, 42);
+		int key;
+
+		AVLCounters::reset();
+		AVL<int> tree;
+		while (keys.next(key))
+			tree.insert(key, key);
+
+		cout << "{\"keys\": " << n << ", \"avl\": ";
+		AVLCounters::writeJson(cout);
+		cout << ", \"shape\": ";
+		tree.stats().writeJson(cout);
+		cout << "}" << endl;
+	}
+#endif
+}
+
+
+/*******************************************************************************
+ * SUITE - list
+ * -----------------------------------------------------------------------------
+ * Fills a List to n items and drains it again, round after round, printing
+ * the live heap and the link pool's reservation at checkpoints. With pooled
+ * links both stay flat after the first round; std::list is timed alongside.
+ ******************************************************************************/
+void suiteList(long maxSize)
+{
+	const long ROUNDS = 1000;
+
+	printf("\n%-10s %10s %8s %12s %12s %10s\n",
+	       "container", "items", "round", "heap bytes", "pool bytes", "ns/op");
+
+	for (long n = 1000; n <= maxSize && n * ROUNDS <= 100000000L; n *= 10)
+	{
+		List<int> list;
+		long before = liveBytes;
+		long sink = 0;
+		Clock::time_point start = Clock::now();
+
+		for (long round = 1; round <= ROUNDS; ++round)
+		{
+			for (long i = 0; i < n; ++i)
+				list.push((int)i);
+			while (!list.isEmpty())
+				sink += list.pop();
+
+			if (round == 1 || round == 10 || round == ROUNDS)
+				printf("%-10s %10ld %8ld %12ld %12ld %10.1f\n", "List", n, round,
+				       liveBytes - before, LinkPool<int>::reservedBytes(),
+				       elapsedNs(start) / (2.0 * n * round));
+		}
+
+		std::list<int> baseline;
+		before = liveBytes;
+		start = Clock::now();
+		for (long round = 1; round <= ROUNDS; ++round)
+		{
+			for (long i = 0; i < n; ++i)
+				baseline.push_front((int)i);
+			while (!baseline.empty())
+			{
+				sink += baseline.front();
+				baseline.pop_front();
+			}
+		}
+		printf("%-10s %10ld %8ld %12ld %12s %10.1f\n", "std::list", n, ROUNDS,
+		       liveBytes - before, "-", elapsedNs(start) / (2.0 * n * ROUNDS));
+
+		if (sink == 42)
+			printf(" ");
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - suiteIngest
+ * -----------------------------------------------------------------------------
+ * This function feeds an AVL tree from producer threads through a queue. The
+ * baseline guards a List with a mutex and inserts key by key; the queue run
+ * lets producers push without a lock while the consumer drains batches into
+ * insertBatch. Times are wall clock for all keys, producers included. Heap
+ * bytes are not reported, since the accounting in operator new is not meant
+ * for several threads at once.
+ ******************************************************************************/
+void suiteIngest(long maxSize)
+{
+	const int PRODUCERS = 4;
+	const int BATCH     = 1024;
+
+	printf("\n%-10s %10s %10s %10s\n", "queue", "keys", "producers", "ns/key");
+
+	for (long n = 1000; n <= maxSize; n *= 10)
+	{
+		long per = n / PRODUCERS;
+
+		// BASELINE - List behind a mutex
+		{
+			AVL<int> tree;
+			List<int> list;
+			mutex lock;
+			vector<thread> producers;
+			Clock::time_point start = Clock::now();
+
+			for (int p = 0; p < PRODUCERS; ++p)
+				producers.push_back(thread([&, p]() {
+					Workload keys(UNIFORM, per, 42 + p);
+					int key;
+					while (keys.next(key))
+					{
+						lock_guard<mutex> guard(lock);
+						list.add(key);
+					}
+				}));
+
+			for (long done = 0; done < per * PRODUCERS; )
+			{
+				lock_guard<mutex> guard(lock);
+				while (!list.isEmpty())
+				{
+					int key = list.pop();
+					tree.insert(key, key);
+					++done;
+				}
+			}
+			for (size_t p = 0; p < producers.size(); ++p)
+				producers[p].join();
+			printf("%-10s %10ld %10d %10.1f\n", "mutex", per * PRODUCERS, PRODUCERS,
+			       elapsedNs(start) / (per * PRODUCERS));
+		}
+
+		// MPSC - lock-free pushes, batched inserts
+		{
+			AVL<int> tree;
+			MPSCQueue<pair<int, int> > queue;
+			pair<int, int> batch[BATCH];
+			vector<thread> producers;
+			Clock::time_point start = Clock::now();
+
+			for (int p = 0; p < PRODUCERS; ++p)
+				producers.push_back(thread([&, p]() {
+					Workload keys(UNIFORM, per, 42 + p);
+					int key;
+					while (keys.next(key))
+						queue.push(make_pair(key, key));
+				}));
+
+			for (long done = 0; done < per * PRODUCERS; )
+			{
+				int got = queue.pop_batch(batch, BATCH);
+				tree.insertBatch(batch, got);
+				done += got;
+			}
+			for (size_t p = 0; p < producers.size(); ++p)
+				producers[p].join();
+			printf("%-10s %10ld %10d %10.1f\n", "mpsc", per * PRODUCERS, PRODUCERS,
+			       elapsedNs(start) / (per * PRODUCERS));
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - suiteBuild
+ * -----------------------------------------------------------------------------
+ * This function bulk loads shuffled keys with AVL::build on pools of 1, 2, 4
+ * ... threads up to the core count, next to inserting the same keys one by
+ * one. Speedup is against the one thread build.
+ ******************************************************************************/
+void suiteBuild(long maxSize)
+{
+	int cores = max(1, (int)thread::hardware_concurrency());
+
+	printf("\n%-10s %10s %8s %10s %8s\n", "method", "keys", "threads", "ns/key", "speedup");
+
+	for (long n = 1000; n <= maxSize; n *= 10)
+	{
+		vector<pair<int, int> > items(n);
+		Workload keys(SHUFFLED, n, 42);
+		int key;
+
+		{
+			AVL<int> tree;
+			Clock::time_point start = Clock::now();
+			while (keys.next(key))
+				tree.insert(key, key);
+			printf("%-10s %10ld %8d %10.1f %8s\n", "insert", n, 1, elapsedNs(start) / n, "-");
+		}
+
+		double single = 0;
+		for (int threads = 1; ; threads = min(threads * 2, cores))
+		{
+			ForkJoin pool(threads);
+			AVL<int> tree;
+
+			keys.rewind();
+			for (long i = 0; keys.next(key); ++i)
+				items[i] = make_pair(key, key);
+
+			Clock::time_point start = Clock::now();
+			tree.build(&items[0], n, pool);
+			double ns = elapsedNs(start);
+
+			if (threads == 1)
+				single = ns;
+			printf("%-10s %10ld %8d %10.1f %8.2f\n", "build", n, threads, ns / n, single / ns);
+
+			if (threads == cores)
+				break;
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - suiteSetOps
+ * -----------------------------------------------------------------------------
+ * This function times union, intersection and difference of two trees of n
+ * uniform keys from [0, 2n), so about two in five keys are shared. The loop
+ * method walks one tree and inserts into, or looks up in, the other one key
+ * at a time. The merge method runs std::set_union and friends over the two
+ * in-order streams into a vector and bulk builds the result on one thread.
+ * The join method is AVL::unionWith and friends on pools of 1, 2, 4 ...
+ * threads. Speedup is against the merge.
+ ******************************************************************************/
+void loadSetOp(AVL<int> &tree, vector<pair<int, int> > &items, long n, uint64_t seed)
+{
+	Workload keys(UNIFORM, n, seed, 2 * n);
+	int key;
+
+	for (long i = 0; keys.next(key); ++i)
+		items[i] = make_pair(key, key);
+	tree.build(&items[0], n);
+}
+
+double loopSetOp(int op, AVL<int> &a, AVL<int> &b)
+{
+	AVL<int> result;
+	Clock::time_point start = Clock::now();
+
+	if (op == 0)
+	{
+		for (AVLIter<int> it = b.begin(); it != b.end(); ++it)
+			a.insert(it.id(), *it);
+		return elapsedNs(start);
+	}
+
+	for (AVLIter<int> it = a.begin(); it != a.end(); ++it)
+		if ((b.find(it.id()) != NULL) == (op == 1))
+			result.insert(it.id(), *it);
+	return elapsedNs(start);
+}
+
+// reads a tree's in-order (key, item) pairs for the std set algorithms
+struct PairStream
+{
+	typedef input_iterator_tag iterator_category;
+	typedef pair<int, int>     value_type;
+	typedef ptrdiff_t          difference_type;
+	typedef pair<int, int>    *pointer;
+	typedef pair<int, int>     reference;
+
+	AVLIter<int> it;
+
+	PairStream(AVLIter<int> at) : it(at) {}
+	pair<int, int> operator * ()                        { return make_pair(it.id(), *it); }
+	PairStream&    operator ++ ()                       { ++it; return *this; }
+	PairStream     operator ++ (int)                    { PairStream was = *this; ++it; return was; }
+	bool           operator == (const PairStream& other) const { return it == other.it; }
+	bool           operator != (const PairStream& other) const { return it != other.it; }
+};
+
+double mergeSetOp(int op, AVL<int> &a, AVL<int> &b, long n)
+{
+	ForkJoin single(1);
+	vector<pair<int, int> > merged;
+	auto keyLess = [](const pair<int, int> &x, const pair<int, int> &y) { return x.first < y.first; };
+	PairStream aFirst(a.begin()), aLast(a.end()), bFirst(b.begin()), bLast(b.end());
+	Clock::time_point start = Clock::now();
+
+	merged.reserve(op == 0 ? 2 * n : n);
+	if (op == 0)
+		set_union(aFirst, aLast, bFirst, bLast, back_inserter(merged), keyLess);
+	else if (op == 1)
+		set_intersection(aFirst, aLast, bFirst, bLast, back_inserter(merged), keyLess);
+	else
+		set_difference(aFirst, aLast, bFirst, bLast, back_inserter(merged), keyLess);
+	a.build(merged.empty() ? NULL : &merged[0], merged.size(), single);
+	return elapsedNs(start);
+}
+
+void suiteSetOps(long maxSize)
+{
+	static const char *ops[] = { "union", "intersect", "difference" };
+	int cores = max(1, (int)thread::hardware_concurrency());
+
+	printf("\n%-10s %-8s %10s %8s %10s %8s\n", "op", "method", "keys", "threads", "ns/key", "speedup");
+
+	for (long n = 1000; n <= maxSize; n *= 10)
+	{
+		vector<pair<int, int> > items(n);
+
+		for (int op = 0; op < 3; ++op)
+		{
+			double merge;
+			{
+				AVL<int> a, b;
+				loadSetOp(a, items, n, 42);
+				loadSetOp(b, items, n, 43);
+				double loop = loopSetOp(op, a, b);
+				printf("%-10s %-8s %10ld %8d %10.1f %8s\n", ops[op], "loop", n, 1, loop / n, "-");
+			}
+			{
+				AVL<int> a, b;
+				loadSetOp(a, items, n, 42);
+				loadSetOp(b, items, n, 43);
+				merge = mergeSetOp(op, a, b, n);
+				printf("%-10s %-8s %10ld %8d %10.1f %8s\n", ops[op], "merge", n, 1, merge / n, "-");
+			}
+
+			for (int threads = 1; ; threads = min(threads * 2, cores))
+			{
+				ForkJoin pool(threads);
+				AVL<int> a, b;
+				loadSetOp(a, items, n, 42);
+				loadSetOp(b, items, n, 43);
+
+				Clock::time_point start = Clock::now();
+				if (op == 0)
+					a.unionWith(b, pool);
+				else if (op == 1)
+					a.intersect(b, pool);
+				else
+					a.difference(b, pool);
+				double ns = elapsedNs(start);
+
+				printf("%-10s %-8s %10ld %8d %10.1f %8.2f\n", ops[op], "join", n, threads, ns / n, merge / ns);
+
+				if (threads == cores)
+					break;
+			}
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - suiteTraverse
+ * -----------------------------------------------------------------------------
+ * This function sums a hash of every item, once with an AVLIter walk and once
+ * with AVL::parallelReduce on pools of 1, 2, 4 ... threads. Speedup is against
+ * the iterator walk.
+ ******************************************************************************/
+void suiteTraverse(long maxSize)
+{
+	int cores = max(1, (int)thread::hardware_concurrency());
+	auto hash = [](int id, const int &item) { return (uint64_t)(id ^ item) * 0x9e3779b97f4a7c15ull; };
+	auto add  = [](uint64_t a, uint64_t b) { return a + b; };
+
+	printf("\n%-10s %10s %8s %10s %8s\n", "method", "keys", "threads", "ns/key", "speedup");
+
+	for (long n = 1000; n <= maxSize; n *= 10)
+	{
+		vector<pair<int, int> > items(n);
+		Workload keys(SHUFFLED, n, 42);
+		AVL<int> tree;
+		int key;
+
+		for (long i = 0; keys.next(key); ++i)
+			items[i] = make_pair(key, key);
+		tree.build(&items[0], n);
+
+		uint64_t expect = 0;
+		Clock::time_point start = Clock::now();
+		for (AVLIter<int> it = tree.begin(); it != tree.end(); ++it)
+			expect += hash(it.id(), *it);
+		double walk = elapsedNs(start);
+		printf("%-10s %10ld %8d %10.1f %8s\n", "iterator", n, 1, walk / n, "-");
+
+		for (int threads = 1; ; threads = min(threads * 2, cores))
+		{
+			ForkJoin pool(threads);
+
+			start = Clock::now();
+			uint64_t sum = tree.parallelReduce((uint64_t)0, hash, add, pool);
+			double ns = elapsedNs(start);
+
+			if (sum != expect)
+				printf("parallelReduce disagrees with the iterator walk\n");
+			printf("%-10s %10ld %8d %10.1f %8.2f\n", "reduce", n, threads, ns / n, walk / ns);
+
+			if (threads == cores)
+				break;
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - suiteSharded
+ * -----------------------------------------------------------------------------
+ * This function measures insert then find throughput as threads are added.
+ * Each thread inserts its own n / threads uniform keys and then looks every
+ * one of them up. The baseline is one AVL behind one mutex; the others are a
+ * ShardedAVL with one shard per core, range and hash routed.
+ ******************************************************************************/
+template<class Insert, class Find>
+double timeThreads(int threads, long per, Insert insert, Find find)
+{
+	vector<thread> workers;
+	Clock::time_point start = Clock::now();
+
+	for (int t = 0; t < threads; ++t)
+		workers.push_back(thread([&, t]() {
+			Workload keys(UNIFORM, per, 42 + t);
+			int key;
+			while (keys.next(key))
+				insert(key);
+			keys.rewind();
+			while (keys.next(key))
+				find(key);
+		}));
+	for (size_t t = 0; t < workers.size(); ++t)
+		workers[t].join();
+	return elapsedNs(start);
+}
+
+void suiteSharded(long maxSize)
+{
+	int cores = max(1, (int)thread::hardware_concurrency());
+	int most  = max(cores, 4);
+
+	printf("\n%-10s %10s %8s %10s\n", "tree", "keys", "threads", "Mops/s");
+
+	for (long n = 1000; n <= maxSize; n *= 10)
+	{
+		for (int threads = 1; ; threads = min(threads * 2, most))
+		{
+			long per = n / threads;
+			double ops = 2.0 * per * threads;
+			double ns;
+
+			{
+				AVL<int> tree;
+				mutex lock;
+				ns = timeThreads(threads, per,
+					[&](int key) { lock_guard<mutex> guard(lock); tree.insert(key, key); },
+					[&](int key) { lock_guard<mutex> guard(lock); tree.find(key); });
+				printf("%-10s %10ld %8d %10.2f\n", "mutex", per * threads, threads, ops * 1000 / ns);
+			}
+
+			ShardRouting routings[] = { RANGE_ROUTED, HASH_ROUTED };
+			for (int r = 0; r < 2; ++r)
+			{
+				ShardedAVL<int> tree(cores, routings[r]);
+				ns = timeThreads(threads, per,
+					[&](int key) { tree.insert(key, key); },
+					[&](int key) { int item; tree.find(key, item); });
+				printf("%-10s %10ld %8d %10.2f\n", r == 0 ? "range" : "hash", per * threads,
+				       threads, ops * 1000 / ns);
+			}
+
+			if (threads == most)
+				break;
+		}
+	}
+}
+
+
+/*******************************************************************************
+ * FUNCTION - suitePacked
+ * -----------------------------------------------------------------------------
+ * This function compares an AVL<int> with the PackedKeys copy of its keys:
+ * bytes per key, a successful lookup of every key in shuffled order, and an
+ * ordered scan. Dense keys are 0..n-1; sparse keys are uniform over the int
+ * range.
+ ******************************************************************************/
+void suitePacked(long maxSize)
+{
+	static const char *kinds[] = { "dense", "sparse" };
+
+	printf("\n%-8s %-8s %10s %10s %10s %10s\n", "keys", "tree", "count", "bytes/key", "find ns", "scan ns");
+
+	for (long n = 1000; n <= maxSize; n *= 10)
+	{
+		for (int kind = 0; kind < 2; ++kind)
+		{
+			AVL<int> tree;
+			vector<int> probes;
+			Workload keys(kind == 0 ? SHUFFLED : UNIFORM, n, 42);
+			int key;
+
+			while (keys.next(key))
+				if (tree.insert(key, key))
+					probes.push_back(key);
+			long count = probes.size();
+
+			PackedKeys packed;
+			packed.build(tree);
+
+			long found = 0;
+			long sum   = 0;
+			Clock::time_point start = Clock::now();
+			for (long i = 0; i < count; ++i)
+				found += tree.find(probes[i]) != NULL;
+			double find = elapsedNs(start) / count;
+
+			start = Clock::now();
+			for (AVLIter<int> it = tree.begin(); it != tree.end(); ++it)
+				sum += it.id();
+			double scan = elapsedNs(start) / count;
+			printf("%-8s %-8s %10ld %10.2f %10.1f %10.2f\n", kinds[kind], "avl", count,
+			       (double)tree.stats().bytes / count, find, scan);
+
+			start = Clock::now();
+			for (long i = 0; i < count; ++i)
+				found -= packed.contains(probes[i]);
+			find = elapsedNs(start) / count;
+
+			start = Clock::now();
+			packed.forEach([&](int id) { sum -= id; });
+			scan = elapsedNs(start) / count;
+			printf("%-8s %-8s %10ld %10.2f %10.1f %10.2f\n", kinds[kind], "packed", count,
+			       (double)packed.bytes() / count, find, scan);
+
+			if (found != 0 || sum != 0)
+				printf("packed keys disagree with the tree\n");
+		}
+	}
+}
+
+
+int main(int argc, char *argv[])
+{
+	const char *suite = argc > 1 ? argv[1] : "core";
+	long maxSize = argc > 2 ? atol(argv[2]) : 1000000;
+	bool all = !strcmp(suite, "all");
+
+	if (all || !strcmp(suite, "core"))
+		suiteCore(maxSize);
+	if (all || !strcmp(suite, "bptree"))
+		suiteBPTree(maxSize);
+	if (all || !strcmp(suite, "counters"))
+		suiteCounters(maxSize);
+	if (all || !strcmp(suite, "list"))
+		suiteList(maxSize);
+	if (all || !strcmp(suite, "ingest"))
+		suiteIngest(maxSize);
+	if (all || !strcmp(suite, "build"))
+		suiteBuild(maxSize);
+	if (all || !strcmp(suite, "setops"))
+		suiteSetOps(maxSize);
+	if (all || !strcmp(suite, "traverse"))
+		suiteTraverse(maxSize);
+	if (all || !strcmp(suite, "sharded"))
+		suiteSharded(maxSize);
+	if (all || !strcmp(suite, "packed"))
+		suitePacked(maxSize);
+	return 0;
+}
@@ -3,122 +3,438 @@
  * DATE       : 8/29/2017
  ******************************************************************************/
 #include "AVL.h"
+#include "AVLMultimap.h"
+#include "BoundedCache.h"
+#include "Sequence.h"
+#include "StaticAVL.h"
+#include "TTLCache.h"
+#include "TreeExport.h"
 #include "TreePrinter.h"
+#include "Workload.h"
 
 #include <algorithm>
 #include <time.h>
 #include <sys/time.h>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
 
 
 /*******************************************************************************
- * FUNCTION knuthRand
+ * STATIC TABLE - built by the compiler, so its lookups are checked at compile
+ *                time as well as at run time
+ ******************************************************************************/
+constexpr StaticPair<int> PRIMES[] = { {2, 20}, {3, 30}, {5, 50}, {7, 70},
+                                       {11, 110}, {13, 130} };
+constexpr StaticAVL<int, 6> PRIME_TABLE = makeStaticAVL(PRIMES);
+
+static_assert(*PRIME_TABLE.find(7) == 70 && *PRIME_TABLE.find(13) == 130 &&
+              !PRIME_TABLE.find(4) && !PRIME_TABLE.find(14),
+              "StaticAVL lookups must resolve at compile time");
+
+
+/*******************************************************************************
+ * FUNCTION - fill
+ * -----------------------------------------------------------------------------
+ * Inserts every key of keys into tree with the item 2 * key + mark, so a
+ * check can tell afterwards which tree a node came from.
+ ******************************************************************************/
+void fill(AVL<int>& tree, const set<int>& keys, int mark)
+{
+	for (set<int>::const_iterator key = keys.begin(); key != keys.end(); ++key)
+		tree.insert(*key, 2 * *key + mark);
+}
+
+
+/*******************************************************************************
+ * FUNCTION - holds
  * -----------------------------------------------------------------------------
- * This method will randomly shuffle a list based on the Knuth Random shuffling
- * algorithm.
+ * return: bool - if tree is a valid AVL tree holding exactly the keys of
+ *                keys, those in marked with an odd item and the rest even
  ******************************************************************************/
-void knuthRand(int list[], int BOUND)
+bool holds(AVL<int>& tree, const set<int>& keys, const set<int>& marked)
 {
-	int shuffles[BOUND];
+	set<int>::const_iterator key = keys.begin();
+
+	if (!tree.validate())
+		return false;
+	for (AVLIter<int> it = tree.begin(); it != tree.end(); ++it, ++key)
+		if (key == keys.end() || it.id() != *key
+		    || *it != 2 * *key + (int)marked.count(*key))
+			return false;
+	return key == keys.end();
+}
 
-	// generate random numbers
-	for(int i = 0; i < BOUND; ++i)
+
+/*******************************************************************************
+ * FUNCTION - checkSetOps
+ * -----------------------------------------------------------------------------
+ * Compares unionWith, intersect, difference, splitOff and concat with
+ * std::set on seeded random trees, on one ForkJoin thread and on several.
+ * The large trees are tall enough for the set operations to fork. Where both
+ * trees hold a key the receiver's (even) item must be the one kept.
+ * -----------------------------------------------------------------------------
+ * return: bool - if every result matched
+ ******************************************************************************/
+bool checkSetOps()
+{
+	const int THREADS[] = { 1, 4 };
+	const int SIZES[]   = { 0, 1, 50, 300, 20000 };
+	Rng rng(7);
+
+	for (int t = 0; t < 2; ++t)
 	{
-		list[i] = i;
+		ForkJoin pool(THREADS[t]);
+
+		for (int s = 0; s < 5; ++s)
+		{
+			const int span = 3 * SIZES[s] + 1;
+			set<int> inA, inB, none, expected;
+			AVL<int> a, b, result;
+
+			for (int i = 0; i < SIZES[s]; ++i)
+			{
+				inA.insert((int)rng.below(span));
+				inB.insert((int)rng.below(span));
+			}
+			fill(a, inA, 0);
+			fill(b, inB, 1);
+
+			// UNION - keys only in b keep b's odd items
+			fill(result, inA, 0);
+			result.unionWith(b, pool);
+			expected = inA;
+			expected.insert(inB.begin(), inB.end());
+			set<int> onlyB;
+			set_difference(inB.begin(), inB.end(), inA.begin(), inA.end(),
+			               inserter(onlyB, onlyB.begin()));
+			if (!holds(result, expected, onlyB))
+				return false;
+
+			// INTERSECTION
+			result.clear();
+			fill(result, inA, 0);
+			result.intersect(b, pool);
+			expected.clear();
+			set_intersection(inA.begin(), inA.end(), inB.begin(), inB.end(),
+			                 inserter(expected, expected.begin()));
+			if (!holds(result, expected, none))
+				return false;
+
+			// DIFFERENCE
+			result.clear();
+			fill(result, inA, 0);
+			result.difference(b, pool);
+			expected.clear();
+			set_difference(inA.begin(), inA.end(), inB.begin(), inB.end(),
+			               inserter(expected, expected.begin()));
+			if (!holds(result, expected, none))
+				return false;
 
-		// CALC - hash the random number to an index
-		shuffles[i] = rand() % BOUND;
+			// OPERAND - other is left as it was
+			if (!holds(b, inB, inB))
+				return false;
+
+			// SPLIT / CONCATENATE - at a random key and back again
+			AVL<int> upper;
+			int cut = (int)rng.below(span + 2) - 1;
+			a.splitOff(cut, upper);
+			if (!holds(a, set<int>(inA.begin(), inA.lower_bound(cut)), none) ||
+			    !holds(upper, set<int>(inA.lower_bound(cut), inA.end()), none))
+				return false;
+			upper.concat(a);
+			if (!holds(upper, inA, none) || a.root)
+				return false;
+		}
 	}
+	return true;
+}
+
 
-	// perform shuffles
-	for(int i = 0; i < BOUND; ++i)
+/*******************************************************************************
+ * FUNCTION - checkRemove
+ * -----------------------------------------------------------------------------
+ * Runs a seeded mix of inserts, removes and range removes against std::set,
+ * validating the whole tree and comparing its keys after every removal.
+ * -----------------------------------------------------------------------------
+ * return: bool - if the tree matched after every step
+ ******************************************************************************/
+bool checkRemove()
+{
+	const int KEYS = 400;
+	set<int> none, keys;
+	AVL<int> tree;
+	Rng rng(11);
+
+	for (int step = 0; step < 6000; ++step)
 	{
-		int temp = list[i];
-		list[i] = list[shuffles[i]];
-		list[shuffles[i]] = temp;
+		int  id   = (int)rng.below(KEYS);
+		long roll = (long)rng.below(20);
+
+		if (roll < 10)
+		{
+			if (tree.insert(id, 2 * id) != keys.insert(id).second)
+				return false;
+			continue;
+		}
+
+		if (roll < 19)
+		{
+			if (tree.remove(id) != (keys.erase(id) == 1))
+				return false;
+		}
+		else
+		{
+			int  hi      = id + (int)rng.below(KEYS / 8);
+			long removed = 0;
+			while (!keys.empty() && keys.lower_bound(id) != keys.upper_bound(hi))
+			{
+				keys.erase(keys.lower_bound(id));
+				++removed;
+			}
+			if (tree.removeRange(id, hi) != removed)
+				return false;
+		}
+
+		if (!holds(tree, keys, none))
+			return false;
 	}
+	return true;
 }
 
 
 /*******************************************************************************
- * FUNCTION - heightCheck
+ * FUNCTION - checkTTL
  * -----------------------------------------------------------------------------
- * This function will recursively check each node on a binary tree to see if
- * both node's children heights are within the bounds of an AVL tree node.
+ * Puts entries with random expiries into a TTLCache, some of them replacing
+ * or erasing earlier ones, and sweeps each tick, first with a small budget
+ * and then without. Every get and every sweep is compared with a plain map
+ * of expiries.
  * -----------------------------------------------------------------------------
- * Return:
- * 		If the tree's node heights are valid for the definition of an AVL tree,
- * 		returns True else False
+ * return: bool - if the cache matched at every tick
  ******************************************************************************/
-bool heightCheckOK = true;
-int heightCheck(Node<int> *node)
+bool checkTTL()
 {
-	if (node)
+	const int KEYS = 300;
+	TTLCache<int> cache;
+	map<int, int> expires;  // id to expiry tick, NEVER for none
+	Rng rng(13);
+
+	for (int now = 0; now < 400; ++now)
 	{
-		int lHeight = heightCheck(node->left);
-		int rHeight = heightCheck(node->right);
-		int heightDiff = abs(lHeight - rHeight);
+		for (int i = 0; i < 8; ++i)
+		{
+			int id = (int)rng.below(KEYS);
+
+			if (rng.below(6) == 0)
+			{
+				if (cache.erase(id) != (expires.erase(id) == 1))
+					return false;
+				continue;
+			}
+
+			int expiry = rng.below(10) == 0 ? TTLCache<int>::NEVER
+			                                 : now + 1 + (int)rng.below(30);
+			cache.put(id, id, expiry);
+			expires[id] = expiry;
+		}
+
+		for (int id = 0; id < KEYS; ++id)
+		{
+			map<int, int>::iterator at = expires.find(id);
+			bool live = at != expires.end() && at->second > now;
+			int  item = -1;
 
-		heightCheckOK = heightCheckOK && (heightDiff <= 1);
+			if (cache.get(id, now, item) != live || (live && item != id))
+				return false;
+		}
 
-		return max(lHeight, rHeight) + 1;
+		// SWEEP - a small budget first, then whatever it left
+		long swept = cache.sweep(now, 5);
+		swept += cache.sweep(now);
+		for (map<int, int>::iterator at = expires.begin(); at != expires.end(); )
+			if (at->second <= now)
+			{
+				expires.erase(at++);
+				--swept;
+			}
+			else
+				++at;
+		if (swept != 0 || cache.size() != (long)expires.size())
+			return false;
 	}
-	else
-		return 0;
+
+	// SWEEP - everything by the end of time
+	for (map<int, int>::iterator at = expires.begin(); at != expires.end(); )
+		if (at->second != TTLCache<int>::NEVER)
+			expires.erase(at++);
+		else
+			++at;
+	cache.sweep(TTLCache<int>::NEVER - 1);
+	return cache.size() == (long)expires.size();
 }
-bool AVLTest_heightCheck(Node<int> *node)
+
+
+/*******************************************************************************
+ * FUNCTION - checkCaches
+ * -----------------------------------------------------------------------------
+ * Fills a BoundedCache of three entries under each policy and checks which
+ * entry each new key evicts and what the counters record, then that
+ * capacityFor sizes entries by the node bytes stats() reports.
+ * -----------------------------------------------------------------------------
+ * return: bool - if every eviction, counter and capacity was as expected
+ ******************************************************************************/
+bool checkCaches()
 {
-	heightCheck(node);
-	return heightCheckOK;
+	BoundedCache<int> lru(3, EVICT_LRU);
+	BoundedCache<int> lfu(3, EVICT_LFU);
+
+	// LRU - 1 is used again, so 2 is the least recent when 4 arrives
+	lru.put(1, 10);
+	lru.put(2, 20);
+	lru.put(3, 30);
+	if (!lru.get(1) || *lru.get(1) != 10)
+		return false;
+	lru.put(4, 40);
+	if (lru.get(2) || !lru.get(3) || lru.size() != 3)
+		return false;
+	lru.put(5, 50);  // 1 is least recent now
+	if (lru.get(1) || !lru.get(4) || !lru.get(5))
+		return false;
+
+	CacheCounters counted = lru.counters();
+	if (counted.hits != 5 || counted.misses != 2 || counted.evictions != 2)
+		return false;
+
+	// LFU - 2 and 3 are used least, and 2 less recently, when 4 arrives;
+	//       then 3 is used again and 4 is the least used
+	lfu.put(1, 10);
+	lfu.put(2, 20);
+	lfu.put(3, 30);
+	lfu.get(1);
+	lfu.get(1);
+	lfu.put(4, 40);
+	if (lfu.get(2) || !lfu.get(3))
+		return false;
+	lfu.put(5, 50);
+	if (lfu.get(4) || !lfu.get(1) || !lfu.get(3) || !lfu.get(5))
+		return false;
+
+	counted = lfu.counters();
+	if (counted.hits != 6 || counted.misses != 2 || counted.evictions != 2)
+		return false;
+	lfu.resetCounters();
+	if (lfu.counters().hits != 0 || !lfu.erase(5) || lfu.size() != 2)
+		return false;
+
+	// SIZING - LFU also pays for a use count list per entry
+	long budget = 1 << 20;
+	return BoundedCache<int>::capacityFor(budget) == budget / AVL<CacheEntry<int> >::nodeBytes()
+	    && BoundedCache<int>::capacityFor(budget, EVICT_LFU) < BoundedCache<int>::capacityFor(budget);
 }
 
 
 /*******************************************************************************
- * FUNCTION - completeAndOrdered
+ * FUNCTION - checkContainers
  * -----------------------------------------------------------------------------
- * This function will recursively check each node on a binary tree to see if
- * 		1) The AVL tree contains all nodes we have added
- * 		2) Nodes are in the order expected by a binary tree
- *      3) There are no duplicate nodes
+ * Compares an AVLMultimap with std::multimap, with enough values under one
+ * key to spill its bucket into chunks; the StaticAVL table with an AVL tree;
+ * Sequence with the linked List on the same seeded operations; and the DOT
+ * and JSON export of tree with its node count.
  * -----------------------------------------------------------------------------
- * Return:
- * 		If the tree's node placements are valid for the definition of an AVL
- * 		tree, returns True else False
+ * return: bool - if every container matched
  ******************************************************************************/
-bool completeAndOrderedOK = true;
-int nodeCount = 0;
-Node<int> *lastLeaf = NULL;
-void completeAndOrdered(Node<int> *node)
+bool checkContainers(AVL<int>& tree, int nodes)
 {
-	if (node)
+	AVLMultimap<int> multi;
+	multimap<int, int> expected;
+	Rng rng(17);
+
+	// MULTIMAP - values in key order, then in insertion order
+	for (int i = 0; i < 400; ++i)
 	{
-		completeAndOrdered(node->left);
+		int id = i % 3 == 0 ? 7 : (int)rng.below(40);
+		multi.insert(id, i);
+		expected.insert(make_pair(id, i));
+	}
 
-		++nodeCount;
-		if (node->left)
-			completeAndOrderedOK &= (node->id > node->left->id);
+	vector<pair<int, int> > visited;
+	multi.forEach([&](int id, int item) { visited.push_back(make_pair(id, item)); });
+	if (visited != vector<pair<int, int> >(expected.begin(), expected.end()) ||
+	    multi.count(7) != (long)expected.count(7) || multi.size() != 400)
+		return false;
 
-		if (node->right)
-			completeAndOrderedOK &= (node->id < node->right->id);
+	multimap<int, int>::iterator want = expected.lower_bound(7);
+	pair<AVLMultimap<int>::iterator, AVLMultimap<int>::iterator> values = multi.equal_range(7);
+	for (; values.first != values.second; ++values.first, ++want)
+		if (*values.first != want->second)
+			return false;
 
-		if (!node->left && !node->right)
+	long removed = multi.removeRange(5, 9);
+	if (removed != (long)distance(expected.lower_bound(5), expected.upper_bound(9)) ||
+	    multi.count(7) != 0 || multi.size() != 400 - removed)
+		return false;
+
+	// STATIC TABLE - the same answers as a tree built at run time
+	AVL<int> primes;
+	for (int i = 0; i < 6; ++i)
+		primes.insert(PRIMES[i].id, PRIMES[i].item);
+	for (int id = -1; id < 16; ++id)
+	{
+		const int *fixed = PRIME_TABLE.find(id);
+		int *found = primes.find(id);
+		if ((fixed == NULL) != (found == NULL) || (fixed && *fixed != *found))
+			return false;
+	}
+
+	// SEQUENCE - the List interface on contiguous storage
+	Sequence<int> sequence;
+	List<int>     linked;   // the linked list unless LIST_CONTIGUOUS is defined
+	for (int i = 0; i < 500; ++i)
+	{
+		int roll = (int)rng.below(4);
+		if (roll == 0 && !linked.isEmpty())
 		{
-			if (lastLeaf)
-				completeAndOrderedOK &= (node->id > lastLeaf->id);
-			lastLeaf = node;
+			if (sequence.pop() != linked.pop())
+				return false;
 		}
+		else if (roll == 1)
+		{
+			sequence.push(i);
+			linked.push(i);
+		}
+		else
+		{
+			sequence.add(i);
+			linked.add(i);
+		}
+	}
+	if (sequence.size() != linked.size())
+		return false;
+	for (int i = 0; i < linked.size(); ++i)
+		if (sequence.getNode(i) != linked.getNode(i))
+			return false;
 
-		completeAndOrdered(node->right);
+	// EXPORT - one DOT edge and one JSON "key" per node below the root
+	ostringstream dot, json;
+	{
+		TreeExport<int> toDot(dot);
+		toDot.dot(tree.root);
+	}
+	{
+		TreeExport<int> toJson(json);
+		toJson.json(tree.root);
 	}
-}
-bool AVLTest_completeAndOrdered(Node<int> *node, int iterationBound)
-{
-	nodeCount = 0;
-	lastLeaf  = NULL;
 
-	completeAndOrdered(node);
-	return completeAndOrderedOK && (nodeCount <= iterationBound);
+	int edges = 0, keys = 0;
+	for (size_t at = dot.str().find(" -> "); at != string::npos; at = dot.str().find(" -> ", at + 1))
+		++edges;
+	for (size_t at = json.str().find("\"key\""); at != string::npos; at = json.str().find("\"key\"", at + 1))
+		++keys;
+	return edges == nodes - 1 && keys == nodes;
 }
 
 
@@ -134,12 +450,15 @@ int main()
 {
 	const int BOUND = 100;
 	int sequence[BOUND];
-	AVL<int> avl = AVL<int>();
+	AVL<int> avl;
 	TreePrinter<int> tPrinter;
 
 	// INITIALIZE - randomize the order in which elements are added to the
 	//              AVL tree.
-	knuthRand(sequence, BOUND);
+	Rng rng(42);
+	for (int i = 0; i < BOUND; ++i)
+		sequence[i] = i;
+	shuffle(sequence, BOUND, rng);
 
 	// PRINT - sequence in which we will add elements to AVL tree
 	cout << "\nSEQUENCE: ";
@@ -149,34 +468,70 @@ int main()
 	cout << endl;
 
 	// BUILD TREES
-	for(int i = 0; i < BOUND; ++i)
+	bool passed = true;
+	for(int i = 0; i < BOUND && passed; ++i)
 	{
 		// INSERT - element into AVL tree
 		avl.insert(sequence[i], sequence[i]);
 
-		// TEST - check heights of each node's children to make sure the AVL
-		//        height property holds throughout the tree
-		if (!AVLTest_heightCheck(avl.root))
+		// TEST - the path the insertion touched holds the AVL height
+		//        property, the key order and consistent parent links
+		if (!avl.validatePath(sequence[i]))
 		{
-			cout << "HEIGHT CHECK FAILED\n\n";
+			cout << "PATH CHECK FAILED\n\n";
 			tPrinter.print(avl.root, cout);
-			break;
+			passed = false;
 		}
+	}
 
-		// TEST - 1) The AVL tree contains all nodes we have added
-		//        2) Nodes are in the order expected by a binary tree
-		//        3) There are no duplicate nodes
-		if (!AVLTest_completeAndOrdered(avl.root, i+1))
-		{
-			cout << "COMPLETE CHECK FAILED\n\n";
-			tPrinter.print(avl.root, cout);
-			break;
-		}
+	// TEST - 1) The whole tree holds the AVL height property
+	//        2) Nodes are in the order expected by a binary tree
+	//        3) There are no duplicate nodes and every node is contained
+	int nodeCount = 0;
+	for (AVLIter<int> it = avl.begin(); it != avl.end(); ++it)
+		++nodeCount;
+
+	if (passed && !(avl.validate() && nodeCount == BOUND))
+	{
+		cout << "TREE CHECK FAILED\n\n";
+		tPrinter.print(avl.root, cout);
+		passed = false;
+	}
+
+	// TEST - set operations, split and concatenate against std::set
+	if (passed && !checkSetOps())
+	{
+		cout << "SET OPERATION CHECK FAILED\n\n";
+		passed = false;
+	}
+
+	// TEST - removal and the TTL cache built on it
+	if (passed && !checkRemove())
+	{
+		cout << "REMOVE CHECK FAILED\n\n";
+		passed = false;
+	}
+	if (passed && !checkTTL())
+	{
+		cout << "TTL CHECK FAILED\n\n";
+		passed = false;
+	}
+
+	// TEST - the caches and containers built on the tree
+	if (passed && !checkCaches())
+	{
+		cout << "CACHE CHECK FAILED\n\n";
+		passed = false;
+	}
+	if (passed && !checkContainers(avl, BOUND))
+	{
+		cout << "CONTAINER CHECK FAILED\n\n";
+		passed = false;
 	}
 
 	// If the AVL tree passes the tests for each node inserted then our final
 	//    representation of the tree is in fact an AVL tree.
-	if (heightCheckOK && completeAndOrderedOK)
+	if (passed)
 	{
 		cout << "THE AVL TREE HAS PASSED" << endl << endl;
 		tPrinter.print(avl.root, cout);